@@ -4,6 +4,10 @@ pub fn build(b: *std.Build) void {
     const target = b.standardTargetOptions(.{});
     const optimize = b.standardOptimizeOption(.{});
 
+    const profile = b.option(bool, "profile", "Record timing zones and write them to scop-trace.json on exit") orelse false;
+    const options = b.addOptions();
+    options.addOption(bool, "profile", profile);
+
     const exe_mod = b.createModule(.{
         .root_source_file = b.path("src/main.zig"),
         .target = target,
@@ -17,16 +21,7 @@ pub fn build(b: *std.Build) void {
 
     // Compile the MiniLibX directly with Zig.
     exe.addCSourceFiles(.{
-        .files = &.{
-            "mlx/mlx_init.c",                   "mlx/mlx_new_window.c",          "mlx/mlx_pixel_put.c",             "mlx/mlx_loop.c",
-            "mlx/mlx_mouse_hook.c",             "mlx/mlx_key_hook.c",            "mlx/mlx_expose_hook.c",           "mlx/mlx_loop_hook.c",
-            "mlx/mlx_int_anti_resize_win.c",    "mlx/mlx_int_do_nothing.c",      "mlx/mlx_int_wait_first_expose.c", "mlx/mlx_int_get_visual.c",
-            "mlx/mlx_flush_event.c",            "mlx/mlx_string_put.c",          "mlx/mlx_set_font.c",              "mlx/mlx_new_image.c",
-            "mlx/mlx_get_data_addr.c",          "mlx/mlx_put_image_to_window.c", "mlx/mlx_get_color_value.c",       "mlx/mlx_clear_window.c",
-            "mlx/mlx_xpm.c",                    "mlx/mlx_int_str_to_wordtab.c",  "mlx/mlx_destroy_window.c",        "mlx/mlx_int_param_event.c",
-            "mlx/mlx_int_set_win_event_mask.c", "mlx/mlx_hook.c",                "mlx/mlx_rgb.c",                   "mlx/mlx_destroy_image.c",
-            "mlx/mlx_mouse.c",                  "mlx/mlx_screen_size.c",         "mlx/mlx_destroy_display.c",
-        },
+        .files = &mlx_sources,
     });
 
     exe.addCSourceFiles(.{
@@ -43,7 +38,8 @@ pub fn build(b: *std.Build) void {
     translate_mlx.addIncludePath(b.path("glad/include/"));
 
     exe.step.dependOn(&translate_mlx.step);
-    exe.root_module.addImport("mlx", translate_mlx.addModule("mlx"));
+    const mlx_mod = translate_mlx.addModule("mlx");
+    exe.root_module.addImport("mlx", mlx_mod);
     exe.root_module.linkSystemLibrary("sdl3", .{});
 
     const argzon_dep = b.dependency("argzon", .{
@@ -52,6 +48,7 @@ pub fn build(b: *std.Build) void {
     });
     const argzon_mod = argzon_dep.module("argzon");
     exe.root_module.addImport("argzon", argzon_mod);
+    exe.root_module.addOptions("build_options", options);
 
     // Add dependencies of the MLX.
     exe.linkSystemLibrary("x11");
@@ -78,4 +75,55 @@ pub fn build(b: *std.Build) void {
 
     const test_step = b.step("test", "Run unit tests");
     test_step.dependOn(&run_exe_unit_tests.step);
+
+    // The OBJ parser needs none of the C code, so its tests build without the window system libraries.
+    const obj_unit_tests = b.addTest(.{
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("src/obj.zig"),
+            .target = target,
+            .optimize = optimize,
+        }),
+    });
+    obj_unit_tests.root_module.addOptions("build_options", options);
+    test_step.dependOn(&b.addRunArtifact(obj_unit_tests).step);
+
+    // The benchmark always runs optimized, it renders headlessly but links the same C code as the viewer.
+    const bench = b.addExecutable(.{
+        .name = "scop-bench",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("src/bench.zig"),
+            .target = target,
+            .optimize = .ReleaseFast,
+        }),
+    });
+    bench.root_module.addCSourceFiles(.{ .files = &mlx_sources });
+    bench.root_module.addCSourceFiles(.{ .files = &.{"glad/src/glad.c"} });
+    bench.root_module.addIncludePath(b.path("glad/include"));
+    bench.root_module.addImport("mlx", mlx_mod);
+    bench.root_module.addImport("argzon", argzon_mod);
+    bench.root_module.addOptions("build_options", options);
+    bench.root_module.linkSystemLibrary("sdl3", .{});
+    bench.linkSystemLibrary("x11");
+    bench.linkSystemLibrary("Xext");
+
+    const bench_cmd = b.addRunArtifact(bench);
+    // Models are listed relative to the project root.
+    bench_cmd.setCwd(b.path("."));
+    if (b.args) |args| {
+        bench_cmd.addArgs(args);
+    }
+
+    const bench_step = b.step("bench", "Benchmark the software renderer (zig build bench -- --baseline <results.json>)");
+    bench_step.dependOn(&bench_cmd.step);
 }
+
+const mlx_sources = [_][]const u8{
+    "mlx/mlx_init.c",                   "mlx/mlx_new_window.c",          "mlx/mlx_pixel_put.c",             "mlx/mlx_loop.c",
+    "mlx/mlx_mouse_hook.c",             "mlx/mlx_key_hook.c",            "mlx/mlx_expose_hook.c",           "mlx/mlx_loop_hook.c",
+    "mlx/mlx_int_anti_resize_win.c",    "mlx/mlx_int_do_nothing.c",      "mlx/mlx_int_wait_first_expose.c", "mlx/mlx_int_get_visual.c",
+    "mlx/mlx_flush_event.c",            "mlx/mlx_string_put.c",          "mlx/mlx_set_font.c",              "mlx/mlx_new_image.c",
+    "mlx/mlx_get_data_addr.c",          "mlx/mlx_put_image_to_window.c", "mlx/mlx_get_color_value.c",       "mlx/mlx_clear_window.c",
+    "mlx/mlx_xpm.c",                    "mlx/mlx_int_str_to_wordtab.c",  "mlx/mlx_destroy_window.c",        "mlx/mlx_int_param_event.c",
+    "mlx/mlx_int_set_win_event_mask.c", "mlx/mlx_hook.c",                "mlx/mlx_rgb.c",                   "mlx/mlx_destroy_image.c",
+    "mlx/mlx_mouse.c",                  "mlx/mlx_screen_size.c",         "mlx/mlx_destroy_display.c",       "mlx/mlx_put_image_async.c",
+};
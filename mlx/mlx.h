@@ -74,6 +74,24 @@ char	*mlx_get_data_addr(void *img_ptr, int *bits_per_pixel,
 */
 int	mlx_put_image_to_window(void *mlx_ptr, void *win_ptr, void *img_ptr,
 				int x, int y);
+/*
+**  Queue a shared memory image straight to the window and return without
+**  waiting for the server. The image data must not be written before
+**  mlx_image_wait returns. Images without shared memory are put synchronously.
+*/
+int	mlx_put_image_to_window_async(void *mlx_ptr, void *win_ptr, void *img_ptr,
+				int x, int y);
+int	mlx_image_wait(void *mlx_ptr, void *img_ptr);
+/*
+**  Region variants, only the width x height rectangle at src_x,src_y of the
+**  image is sent, to x+src_x,y+src_y in the window.
+*/
+int	mlx_put_image_region_to_window(void *mlx_ptr, void *win_ptr,
+				void *img_ptr, int x, int y, int src_x, int src_y,
+				int width, int height);
+int	mlx_put_image_region_to_window_async(void *mlx_ptr, void *win_ptr,
+				void *img_ptr, int x, int y, int src_x, int src_y,
+				int width, int height);
 int	mlx_get_color_value(void *mlx_ptr, int color);
 
 
@@ -88,6 +106,13 @@ int	mlx_expose_hook (void *win_ptr, int (*funct_ptr)(), void *param);
 int	mlx_loop_hook (void *mlx_ptr, int (*funct_ptr)(), void *param);
 int	mlx_loop (void *mlx_ptr);
 int mlx_loop_end (void *mlx_ptr);
+/*
+**  With a timer, mlx_loop sleeps in poll() between X events and only calls the
+**  loop hook every period_ns nanoseconds.
+**  A period of 0 goes back to calling the loop hook continuously.
+**  Return 0 if the timer could not be created.
+*/
+int	mlx_loop_timer (void *mlx_ptr, long period_ns);
 
 /*
 **  hook funct are called as follow :
@@ -14,5 +14,7 @@
 
 int	mlx_destroy_display(t_xvar *xvar)
 {
+	if (xvar->timer_fd >= 0)
+		close(xvar->timer_fd);
 	XCloseDisplay(xvar->display);
 }
@@ -14,6 +14,7 @@
 
 int	mlx_destroy_image(t_xvar *xvar, t_img *img)
 {
+  mlx_image_wait(xvar, img);
   if (img->type == MLX_TYPE_SHM_PIXMAP ||
       img->type == MLX_TYPE_SHM)
     {
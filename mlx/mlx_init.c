@@ -37,6 +37,8 @@ void	*mlx_init()
 	xvar->loop_hook = 0;
 	xvar->loop_param = (void *)0;
 	xvar->do_flush = 1;
+	xvar->pending_list = 0;
+	xvar->timer_fd = -1;
 	xvar->wm_delete_window = XInternAtom (xvar->display, "WM_DELETE_WINDOW", False);
 	xvar->wm_protocols = XInternAtom (xvar->display, "WM_PROTOCOLS", False);
 	mlx_int_deal_shm(xvar);
@@ -75,6 +77,10 @@ int		mlx_int_deal_shm(t_xvar *xvar)
 		xvar->pshm_format = -1;
 		xvar->use_xshm = 0;
 	}
+	if (xvar->use_xshm)
+		xvar->shm_completion = XShmGetEventBase(xvar->display) + ShmCompletion;
+	else
+		xvar->shm_completion = -1;
 }
 
 /*
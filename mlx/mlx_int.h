@@ -30,6 +30,9 @@
 # include <sys/shm.h>
 # include <X11/extensions/XShm.h>
 # include <X11/XKBlib.h>
+# include <poll.h>
+# include <sys/timerfd.h>
+# include <stdint.h>
 /* #include	<X11/xpm.h> */
 
 
@@ -95,6 +98,8 @@ typedef struct	s_img
 	int				format;
 	char			*data;
 	XShmSegmentInfo	shm;
+	int				pending;
+	struct s_img	*next_pending;
 }				t_img;
 
 typedef struct	s_xvar
@@ -116,6 +121,9 @@ typedef struct	s_xvar
 	Atom		wm_delete_window;
 	Atom		wm_protocols;
 	int 		end_loop;
+	int			shm_completion;
+	t_img		*pending_list;
+	int			timer_fd;
 }				t_xvar;
 
 
@@ -133,6 +141,11 @@ void			*mlx_new_image();
 int				shm_att_pb();
 int				mlx_int_get_visual(t_xvar *xvar);
 int				mlx_int_set_win_event_mask(t_xvar *xvar);
+void			mlx_int_shm_complete(t_xvar *xvar, ShmSeg shmseg);
+int				mlx_image_wait();
+int				mlx_put_image_to_window();
+int				mlx_put_image_region_to_window();
+int				mlx_put_image_region_to_window_async();
 int				mlx_int_str_str_cote(char *str,char *find,int len);
 int				mlx_int_str_str(char *str,char *find,int len);
 
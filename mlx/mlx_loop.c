@@ -34,28 +34,94 @@ int			mlx_loop_end(t_xvar *xvar)
 	return (1);
 }
 
+int			mlx_loop_timer(t_xvar *xvar, long period_ns)
+{
+	struct itimerspec	spec;
+
+	if (period_ns <= 0)
+	{
+		if (xvar->timer_fd >= 0)
+			close(xvar->timer_fd);
+		xvar->timer_fd = -1;
+		return (1);
+	}
+	if (xvar->timer_fd < 0)
+		xvar->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (xvar->timer_fd < 0)
+		return (0);
+	spec.it_interval.tv_sec = period_ns / 1000000000;
+	spec.it_interval.tv_nsec = period_ns % 1000000000;
+	spec.it_value = spec.it_interval;
+	if (timerfd_settime(xvar->timer_fd, 0, &spec, 0) == -1)
+		return (0);
+	return (1);
+}
+
+static void	handle_event(t_xvar *xvar, XEvent *ev)
+{
+	t_win_list	*win;
+
+	if (ev->type == xvar->shm_completion)
+	{
+		mlx_int_shm_complete(xvar, ((XShmCompletionEvent *)ev)->shmseg);
+		return ;
+	}
+	win = xvar->win_list;
+	while (win && (win->window!=ev->xany.window))
+		win = win->next;
+
+	if (win && ev->type == ClientMessage && ev->xclient.message_type == xvar->wm_protocols && ev->xclient.data.l[0] == xvar->wm_delete_window && win->hooks[DestroyNotify].hook)
+		win->hooks[DestroyNotify].hook(win->hooks[DestroyNotify].param);
+	if (win && ev->type < MLX_MAX_EVENT && win->hooks[ev->type].hook)
+		mlx_int_param_event[ev->type](xvar, ev, win);
+}
+
+/*
+** Sleep until an X event or a timer expiration arrives.
+** Return 1 if the loop hook is due.
+*/
+
+static int	wait_events(t_xvar *xvar)
+{
+	struct pollfd	fds[2];
+	uint64_t		count;
+
+	fds[0].fd = ConnectionNumber(xvar->display);
+	fds[1].fd = xvar->timer_fd;
+	fds[0].events = POLLIN;
+	fds[1].events = POLLIN;
+	if (poll(fds, 2, -1) <= 0)
+		return (0);
+	return ((fds[1].revents & POLLIN)
+		&& read(fds[1].fd, &count, sizeof(count)) > 0);
+}
+
 int			mlx_loop(t_xvar *xvar)
 {
 	XEvent		ev;
-	t_win_list	*win;
 
 	mlx_int_set_win_event_mask(xvar);
 	xvar->do_flush = 0;
 	while (win_count(xvar) && !xvar->end_loop)
 	{
+		if (xvar->loop_hook && xvar->timer_fd >= 0)
+		{
+			while (!xvar->end_loop && XPending(xvar->display))
+			{
+				XNextEvent(xvar->display,&ev);
+				handle_event(xvar, &ev);
+			}
+			XFlush(xvar->display);
+			if (!xvar->end_loop && wait_events(xvar))
+				xvar->loop_hook(xvar->loop_param);
+			continue ;
+		}
 		while (!xvar->end_loop && (!xvar->loop_hook || XPending(xvar->display)))
 		{
 			XNextEvent(xvar->display,&ev);
-			win = xvar->win_list;
-			while (win && (win->window!=ev.xany.window))
-				win = win->next;
-
-			if (win && ev.type == ClientMessage && ev.xclient.message_type == xvar->wm_protocols && ev.xclient.data.l[0] == xvar->wm_delete_window && win->hooks[DestroyNotify].hook)
-				win->hooks[DestroyNotify].hook(win->hooks[DestroyNotify].param);
-			if (win && ev.type < MLX_MAX_EVENT && win->hooks[ev.type].hook)
-				mlx_int_param_event[ev.type](xvar, &ev, win);
+			handle_event(xvar, &ev);
 		}
-		XSync(xvar->display, False);
+		XFlush(xvar->display);
 		if (xvar->loop_hook)
 			xvar->loop_hook(xvar->loop_param);
 	}
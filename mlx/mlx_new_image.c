@@ -125,6 +125,8 @@ void	*mlx_int_new_image(t_xvar *xvar,int width, int height,int format)
       return ((void *)0);
     }
   img->gc = 0;
+  img->pending = 0;
+  img->next_pending = 0;
   img->size_line = img->image->bytes_per_line;
   img->bpp = img->image->bits_per_pixel;
   img->width = width;
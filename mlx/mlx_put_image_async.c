@@ -0,0 +1,74 @@
+/*
+** mlx_put_image_async.c for MiniLibX in scop
+**
+** Shared memory images are put straight to the window and the server
+** reports with a ShmCompletion event once it has read them. Until then
+** the image stays in xvar->pending_list and its data must not change.
+*/
+
+
+#include	"mlx_int.h"
+
+
+void	mlx_int_shm_complete(t_xvar *xvar, ShmSeg shmseg)
+{
+  t_img	**link;
+
+  link = &(xvar->pending_list);
+  while (*link)
+    {
+      if ((*link)->shm.shmseg == shmseg)
+	{
+	  (*link)->pending = 0;
+	  *link = (*link)->next_pending;
+	  return ;
+	}
+      link = &((*link)->next_pending);
+    }
+}
+
+
+static Bool	is_shm_completion(Display *display, XEvent *ev, XPointer arg)
+{
+  return (ev->type == ((t_xvar *)arg)->shm_completion);
+}
+
+
+int	mlx_image_wait(t_xvar *xvar, t_img *img)
+{
+  XEvent	ev;
+
+  while (img->pending)
+    {
+      XIfEvent(xvar->display, &ev, is_shm_completion, (XPointer)xvar);
+      mlx_int_shm_complete(xvar, ((XShmCompletionEvent *)&ev)->shmseg);
+    }
+  return (1);
+}
+
+
+int	mlx_put_image_region_to_window_async(t_xvar *xvar, t_win_list *win,
+					     t_img *img, int x, int y,
+					     int src_x, int src_y,
+					     int width, int height)
+{
+  if (img->type != MLX_TYPE_SHM && img->type != MLX_TYPE_SHM_PIXMAP)
+    return (mlx_put_image_region_to_window(xvar, win, img, x, y,
+					   src_x, src_y, width, height));
+  mlx_image_wait(xvar, img);
+  XShmPutImage(xvar->display, win->window, win->gc, img->image, src_x, src_y,
+	       x + src_x, y + src_y, width, height, True);
+  img->pending = 1;
+  img->next_pending = xvar->pending_list;
+  xvar->pending_list = img;
+  XFlush(xvar->display);
+  return (1);
+}
+
+
+int	mlx_put_image_to_window_async(t_xvar *xvar, t_win_list *win, t_img *img,
+				      int x, int y)
+{
+  return (mlx_put_image_region_to_window_async(xvar, win, img, x, y, 0, 0,
+					       img->width, img->height));
+}
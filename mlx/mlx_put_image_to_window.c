@@ -13,8 +13,14 @@
 #include	"mlx_int.h"
 
 
-int	mlx_put_image_to_window(t_xvar *xvar,t_win_list *win,t_img *img,
-				int x,int y)
+/*
+** Only the width x height rectangle at src_x,src_y of the image is uploaded
+** and copied, at x+src_x,y+src_y in the window.
+*/
+
+int	mlx_put_image_region_to_window(t_xvar *xvar,t_win_list *win,t_img *img,
+				       int x,int y,int src_x,int src_y,
+				       int width,int height)
 {
   GC	gc;
 
@@ -25,13 +31,21 @@ int	mlx_put_image_to_window(t_xvar *xvar,t_win_list *win,t_img *img,
       XSetClipOrigin(xvar->display, gc, x, y);
     }
   if (img->type==MLX_TYPE_SHM)
-    XShmPutImage(xvar->display,img->pix, win->gc, img->image,0,0,0,0,
-		 img->width,img->height,False);
+    XShmPutImage(xvar->display,img->pix, win->gc, img->image,src_x,src_y,
+		 src_x,src_y,width,height,False);
   if (img->type==MLX_TYPE_XIMAGE)
-    XPutImage(xvar->display,img->pix, win->gc, img->image,0,0,0,0,
-	      img->width,img->height);
+    XPutImage(xvar->display,img->pix, win->gc, img->image,src_x,src_y,
+	      src_x,src_y,width,height);
   XCopyArea(xvar->display,img->pix,win->window, gc,
-	    0,0,img->width,img->height,x,y);
+	    src_x,src_y,width,height,x+src_x,y+src_y);
   if (xvar->do_flush)
     XFlush(xvar->display);
 }
+
+
+int	mlx_put_image_to_window(t_xvar *xvar,t_win_list *win,t_img *img,
+				int x,int y)
+{
+  return (mlx_put_image_region_to_window(xvar,win,img,x,y,0,0,
+					 img->width,img->height));
+}
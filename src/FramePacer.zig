@@ -0,0 +1,73 @@
+const std = @import("std");
+const linux = std.os.linux;
+
+const FramePacer = @This();
+
+/// Clock of every time below, the deadlines are slept on with `clock_nanosleep`.
+const clock = linux.CLOCK.MONOTONIC;
+/// `TIMER_ABSTIME` of `<time.h>`, the request of `clock_nanosleep` is a time on `clock` instead of a duration.
+const timer_abstime = 1;
+
+/// Nanoseconds between two frames, `0` when the frame rate is unlimited.
+period: u64,
+/// Time the pacer was created at, in nanoseconds on `clock`.
+start: u64,
+/// Time of the next frame, in nanoseconds since `start`.
+deadline: u64 = 0,
+
+/// `frame_rate` is in frames per second, `0` never waits.
+pub fn init(frame_rate: u32) !FramePacer {
+    _ = try std.posix.clock_gettime(clock);
+
+    return .{
+        .period = if (frame_rate == 0) 0 else std.time.ns_per_s / frame_rate,
+        .start = now(),
+    };
+}
+
+/// Nanoseconds since the pacer was created.
+pub fn elapsed(self: *FramePacer) u64 {
+    return now() - self.start;
+}
+
+/// Sleep until the deadline of the next frame, then schedule the one after it.
+/// Deadlines are a fixed `period` apart so a late wake up does not delay the following frames.
+pub fn wait(self: *FramePacer) void {
+    if (self.period == 0) {
+        return;
+    }
+
+    const current = self.elapsed();
+    if (current < self.deadline) {
+        sleepUntil(self.start + self.deadline);
+    }
+
+    self.deadline += self.period;
+
+    // More than a whole frame late, skip the missed frames instead of rendering them back to back.
+    if (self.deadline < current) {
+        self.deadline = current + self.period;
+    }
+}
+
+/// Current time on `clock`, which `init` made sure can be read.
+fn now() u64 {
+    const time = std.posix.clock_gettime(clock) catch unreachable;
+    return @as(u64, @intCast(time.sec)) * std.time.ns_per_s + @as(u64, @intCast(time.nsec));
+}
+
+/// Sleep until `time` on `clock`. The wake up time is absolute, so time lost to preemption before the call or
+/// to an interrupted sleep is not added to the frame.
+fn sleepUntil(time: u64) void {
+    const request = linux.timespec{
+        .sec = @intCast(time / std.time.ns_per_s),
+        .nsec = @intCast(time % std.time.ns_per_s),
+    };
+
+    while (true) {
+        const rc = linux.syscall4(.clock_nanosleep, @intFromEnum(clock), timer_abstime, @intFromPtr(&request), 0);
+        if (linux.E.init(rc) != .INTR) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,167 @@
+//! Renders with the software rasterizer into memory, without any window system.
+//! The model follows the same turntable path as in the viewer, advancing one animation step per frame.
+
+const std = @import("std");
+
+const Allocator = std.mem.Allocator;
+const Mesh = @import("Mesh.zig");
+const Texture = @import("Texture.zig");
+const Settings = @import("Settings.zig");
+const Graphics = @import("SoftwareRenderer.zig").Graphics;
+const Color = Graphics.Color;
+
+allocator: Allocator,
+settings: Settings,
+mesh: Mesh,
+texture: ?Texture,
+options: Options,
+
+pub const ImageFormat = enum {
+    tga,
+    ppm,
+};
+
+pub const Options = struct {
+    frame_count: usize = 1,
+    /// Directory the frames are written to, `null` discards them.
+    output_dir: ?[]const u8 = null,
+    format: ImageFormat = .tga,
+};
+
+/// Time spent and work done rendering, file output excluded.
+pub const Report = struct {
+    frame_count: usize = 0,
+    /// Duration of every frame, in nanoseconds.
+    frame_times: []u64 = &.{},
+    /// Triangles set up over every frame.
+    triangle_count: u64 = 0,
+    stats: Graphics.Statistics = .{},
+
+    pub fn deinit(self: *Report, allocator: Allocator) void {
+        allocator.free(self.frame_times);
+    }
+
+    pub fn totalTime(self: Report) u64 {
+        var total: u64 = 0;
+        for (self.frame_times) |time| total += time;
+        return total;
+    }
+};
+
+pub fn init(allocator: Allocator, settings: Settings, mesh: Mesh, texture: ?Texture, options: Options) @This() {
+    return .{
+        .allocator = allocator,
+        .settings = settings,
+        .mesh = mesh,
+        .texture = texture,
+        .options = options,
+    };
+}
+
+pub fn run(self: *const @This()) !void {
+    var report = try self.render();
+    defer report.deinit(self.allocator);
+
+    const seconds = @as(f64, @floatFromInt(report.totalTime())) / std.time.ns_per_s;
+    std.log.info("{} frames in {d:.3} s, {d:.1} frames/s, {} fragments shaded", .{
+        report.frame_count,
+        seconds,
+        @as(f64, @floatFromInt(report.frame_count)) / seconds,
+        report.stats.fragments_shaded,
+    });
+    std.log.info("pipeline statistics: {}", .{report.stats});
+}
+
+/// Render every frame, writing them to `options.output_dir` when set.
+pub fn render(self: *const @This()) !Report {
+    const settings = self.settings;
+
+    var gfx = try Graphics.init(.memory, settings.window_width, settings.window_height, self.allocator, .{
+        .tile_size = settings.tile_size,
+        .thread_count = settings.thread_count,
+    });
+    defer gfx.deinit();
+    gfx.configure(settings);
+
+    if (self.options.output_dir) |dir| {
+        try std.fs.cwd().makePath(dir);
+    }
+
+    var report = Report{
+        .frame_count = self.options.frame_count,
+        .frame_times = try self.allocator.alloc(u64, self.options.frame_count),
+    };
+    errdefer report.deinit(self.allocator);
+
+    var timer = try std.time.Timer.start();
+    var rotation_y: f32 = 0.0;
+
+    for (0..self.options.frame_count) |frame| {
+        timer.reset();
+
+        gfx.clear();
+        try gfx.draw(&self.mesh, .{
+            .texture = self.texture,
+            .position = .{ .x = settings.model_x, .y = settings.model_y, .z = settings.model_z },
+            .rotation = .{ .y = rotation_y },
+            .offset = self.mesh.getMiddlePoint(),
+        });
+        gfx.present();
+
+        report.frame_times[frame] = timer.read();
+        report.triangle_count += gfx.triangles.items.len;
+        report.stats.add(gfx.stats);
+
+        if (self.options.output_dir) |dir| {
+            try self.writeFrame(dir, frame, gfx.framebuffer());
+        }
+
+        if (settings.enable_rotation) {
+            rotation_y += settings.rotation_speed;
+        }
+    }
+
+    return report;
+}
+
+fn writeFrame(self: *const @This(), dir: []const u8, frame: usize, pixels: []const Color) !void {
+    var path_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const path = try std.fmt.bufPrint(&path_buffer, "{s}/frame_{d:0>4}.{s}", .{ dir, frame, @tagName(self.options.format) });
+
+    const file = try std.fs.cwd().createFile(path, .{});
+    defer file.close();
+
+    var buffered = std.io.bufferedWriter(file.writer());
+    const width = self.settings.window_width;
+    const height = self.settings.window_height;
+
+    switch (self.options.format) {
+        .tga => try writeTga(buffered.writer(), width, height, pixels),
+        .ppm => try writePpm(buffered.writer(), width, height, pixels),
+    }
+    try buffered.flush();
+}
+
+/// Uncompressed 32 bits TGA with a top-left origin.
+fn writeTga(writer: anytype, width: usize, height: usize, pixels: []const Color) !void {
+    var header = [_]u8{0} ** 18;
+    header[2] = 2; // Uncompressed true color.
+    std.mem.writeInt(u16, header[12..14], @intCast(width), .little);
+    std.mem.writeInt(u16, header[14..16], @intCast(height), .little);
+    header[16] = 32;
+    header[17] = 0x28; // 8 alpha bits, rows stored top-down.
+    try writer.writeAll(&header);
+
+    for (pixels) |color| {
+        try writer.writeAll(&.{ color.b, color.g, color.r, 0xff - color.t });
+    }
+}
+
+/// Binary PPM, colors only.
+fn writePpm(writer: anytype, width: usize, height: usize, pixels: []const Color) !void {
+    try writer.print("P6\n{} {}\n255\n", .{ width, height });
+
+    for (pixels) |color| {
+        try writer.writeAll(&.{ color.r, color.g, color.b });
+    }
+}
@@ -0,0 +1,75 @@
+//! Log-linear histogram of durations in the spirit of HdrHistogram: every power of two is split into
+//! `sub_bucket_count` linear buckets, so any recorded value is known within about 3% with a fixed amount of memory.
+
+const std = @import("std");
+
+const Histogram = @This();
+
+const sub_bucket_bits = 5;
+const sub_bucket_count = 1 << sub_bucket_bits;
+/// Values below `sub_bucket_count` get their own bucket, then `sub_bucket_count` buckets per power of two up to 2^64.
+const bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+counts: [bucket_count]u64 = [_]u64{0} ** bucket_count,
+count: u64 = 0,
+/// Sum of every recorded value.
+sum: u64 = 0,
+max: u64 = 0,
+
+pub fn record(self: *Histogram, value: u64) void {
+    self.counts[bucketIndex(value)] += 1;
+    self.count += 1;
+    self.sum +|= value;
+    self.max = @max(self.max, value);
+}
+
+pub fn reset(self: *Histogram) void {
+    self.* = .{};
+}
+
+/// Smallest value at least `quantile` (between 0 and 1) of the recorded values are lower or equal to,
+/// rounded up to the end of its bucket. `0` when nothing was recorded.
+pub fn percentile(self: *const Histogram, quantile: f64) u64 {
+    if (self.count == 0) {
+        return 0;
+    }
+
+    const rank: u64 = @max(1, @as(u64, @intFromFloat(@ceil(quantile * @as(f64, @floatFromInt(self.count))))));
+    var seen: u64 = 0;
+    for (self.counts, 0..) |bucket, index| {
+        seen += bucket;
+        if (seen >= rank) {
+            return @min(bucketMax(index), self.max);
+        }
+    }
+    return self.max;
+}
+
+/// Mean of the recorded values, `0` when nothing was recorded.
+pub fn mean(self: *const Histogram) u64 {
+    return if (self.count == 0) 0 else self.sum / self.count;
+}
+
+fn bucketIndex(value: u64) usize {
+    if (value < sub_bucket_count) {
+        return @intCast(value);
+    }
+
+    // The bits following the leading one select the linear bucket inside the power of two.
+    const exponent: u6 = @intCast(63 - @clz(value));
+    const shift = exponent - sub_bucket_bits;
+    const mantissa = (value >> shift) & (sub_bucket_count - 1);
+    return (@as(usize, shift) + 1) * sub_bucket_count + @as(usize, @intCast(mantissa));
+}
+
+/// Largest value falling into the bucket at `index`.
+fn bucketMax(index: usize) u64 {
+    if (index < sub_bucket_count) {
+        return index;
+    }
+
+    const shift: u6 = @intCast(index / sub_bucket_count - 1);
+    const mantissa: u64 = index % sub_bucket_count;
+    const low = (sub_bucket_count + mantissa) << shift;
+    return low + ((@as(u64, 1) << shift) - 1);
+}
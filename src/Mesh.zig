@@ -1,5 +1,8 @@
 const std = @import("std");
 const math = @import("math.zig");
+const profile = @import("profile.zig");
+const obj = @import("obj.zig");
+const mesh_cache = @import("mesh_cache.zig");
 
 const ArrayList = std.ArrayList;
 const Allocator = std.mem.Allocator;
@@ -8,148 +11,115 @@ const Vector3 = math.Vector3;
 
 const Mesh = @This();
 
-pub const Face = struct {
+pub const Face = extern struct {
     vertices: [3]u32,
     textures: [3]u32,
     normals: [3]u32,
 };
 
-vertices: ArrayList(Vector3),
-textureCoords: ArrayList(Vector2),
-normals: ArrayList(Vector3),
-faces: ArrayList(Face),
+/// One distinct `(v, vt, vn)` corner of the faces, with its attributes interleaved.
+pub const Vertex = extern struct {
+    position: Vector3,
+    uv: Vector2,
+    normal: Vector3,
+};
+
+/// Elements as declared by the file, for tools working on the OBJ data itself.
+vertices: []const Vector3,
+textureCoords: []const Vector2,
+normals: []const Vector3,
+faces: []const Face,
+
+/// What the renderers draw: every distinct corner once, and three indices into it per face.
+/// Built from the arrays above by `buildVertexBuffer`.
+vertexBuffer: []const Vertex = &.{},
+indexBuffer: []const u32 = &.{},
 
 allocator: Allocator,
+/// Read-only cache file the arrays point into, see `mesh_cache`. The arrays are owned by `allocator` otherwise.
+mapping: ?[]align(std.heap.page_size_min) const u8 = null,
 
-fn readFace2(
-    nums: []const []const u8,
-    num_vertex: usize,
-    num_normal: usize,
-    num_textures: usize,
-) !Face {
-    var face: Face = undefined;
-
-    for (nums, 0..3) |s, index| {
-        var slashIter = std.mem.splitAny(u8, s, "/");
-        const sv = slashIter.next() orelse return error.InvalidLine; // minimum required (vertex index).
-        const svt = slashIter.next();
-        const svn = slashIter.next();
-
-        // Indices start at 1 in .obj files.
-        face.vertices[index] = try std.fmt.parseInt(u32, sv, 10) - 1;
-        if (face.vertices[index] > num_vertex) return error.InvalidVertexId;
-
-        // TODO: setting value to 0 if not found is not ideal as it required `textureCoords` and `normals` to hold one dummy
-        // element if empty.
-
-        if (svt) |vt| {
-            face.textures[index] = try std.fmt.parseInt(u32, vt, 10) - 1;
-            if (face.textures[index] > num_textures) return error.InvalidTextureCoordsId;
-        } else {
-            face.textures[index] = 0;
-        }
+/// Load the cached mesh of `path` when it is up to date, otherwise parse the file and cache it.
+pub fn loadFromFile(path: []const u8, gpa: Allocator) !Mesh {
+    const zone = profile.begin("load mesh");
+    defer zone.end();
 
-        if (svn) |vn| {
-            face.normals[index] = try std.fmt.parseInt(u32, vn, 10) - 1;
-            if (face.normals[index] > num_normal) return error.InvalidNormalId;
-        } else {
-            face.normals[index] = 0;
+    if (mesh_cache.load(gpa, path)) |cached| {
+        if (cached) |mesh| {
+            return mesh;
         }
+    } else |err| {
+        std.log.warn("unable to load the cached mesh of {s}: {}", .{ path, err });
     }
 
-    return face;
-}
-
-fn readFace(
-    buf: []const u8,
-    faces: *ArrayList(Face),
-    num_vertex: usize,
-    num_normal: usize,
-    num_textures: usize,
-) !void {
-    var splitIter = std.mem.splitAny(u8, buf, " ");
-    const s0 = splitIter.next() orelse return error.InvalidLine;
-    const s1 = splitIter.next() orelse return error.InvalidLine;
-    const s2 = splitIter.next() orelse return error.InvalidLine;
-
-    if (splitIter.next()) |s3| {
-        try faces.append(try readFace2(&[3][]const u8{ s0, s1, s2 }, num_vertex, num_normal, num_textures));
-        try faces.append(try readFace2(&[3][]const u8{ s0, s2, s3 }, num_vertex, num_normal, num_textures));
-    } else {
-        try faces.append(try readFace2(&[3][]const u8{ s0, s1, s2 }, num_vertex, num_normal, num_textures));
-    }
+    const mesh = try parseFile(path, gpa);
+    mesh_cache.store(&mesh, path) catch |err| {
+        std.log.warn("unable to cache the mesh of {s}: {}", .{ path, err });
+    };
+    return mesh;
 }
 
-// TODO: Check for out of bounds.
-
-pub fn loadFromFile(path: []const u8, gpa: Allocator) !Mesh {
+/// Parse an OBJ file, without going through the cache.
+pub fn parseFile(path: []const u8, gpa: Allocator) !Mesh {
     const file = try std.fs.cwd().openFile(path, .{});
-    const file_data = try file.readToEndAlloc(gpa, 800_000_000);
-    defer gpa.free(file_data);
-
-    // Reading line by line is a bottleneck for large files! It's better to read the whole file then reading
-    // each lines, but it will take more memory.
+    defer file.close();
 
-    file.close();
-
-    var vertices = ArrayList(Vector3).init(gpa);
-    var textureCoords = ArrayList(Vector2).init(gpa);
-    var normals = ArrayList(Vector3).init(gpa);
-    var faces = ArrayList(Face).init(gpa);
-
-    errdefer vertices.deinit();
-    errdefer textureCoords.deinit();
-    errdefer normals.deinit();
-    errdefer faces.deinit();
+    const size = (try file.stat()).size;
+    if (size == 0) {
+        return obj.parse(gpa, "", .{});
+    }
 
-    var line_iter = std.mem.splitSequence(u8, file_data, "\n");
+    // Parse the file in place, its pages are read ahead and dropped once parsed so files larger than the
+    // memory can be opened.
+    const file_data = try std.posix.mmap(null, @intCast(size), std.posix.PROT.READ, .{ .TYPE = .PRIVATE }, file.handle, 0);
+    defer std.posix.munmap(file_data);
+    std.posix.madvise(file_data.ptr, file_data.len, std.posix.MADV.SEQUENTIAL) catch {};
 
-    while (line_iter.next()) |line| {
-        if (line.len >= 1 and line[0] == '#') {
-            continue;
-        }
+    return obj.parse(gpa, file_data, .{ .release_pages = true });
+}
 
-        if (line.len >= 2 and std.mem.eql(u8, line[0..2], "v ")) {
-            var iter = std.mem.splitAny(u8, line[2..], " ");
-            const x = try std.fmt.parseFloat(f32, iter.next() orelse return error.InvalidLine);
-            const y = try std.fmt.parseFloat(f32, iter.next() orelse return error.InvalidLine);
-            const z = try std.fmt.parseFloat(f32, iter.next() orelse return error.InvalidLine);
-
-            try vertices.append(Vector3{ .x = x, .y = y, .z = z });
-        } else if (line.len >= 3 and std.mem.eql(u8, line[0..3], "vn ")) {
-            var iter = std.mem.splitAny(u8, line[3..], " ");
-            const x = try std.fmt.parseFloat(f32, iter.next() orelse return error.InvalidLine);
-            const y = try std.fmt.parseFloat(f32, iter.next() orelse return error.InvalidLine);
-            const z = try std.fmt.parseFloat(f32, iter.next() orelse return error.InvalidLine);
-
-            try normals.append(Vector3{ .x = x, .y = y, .z = z });
-        } else if (line.len >= 3 and std.mem.eql(u8, line[0..3], "vt ")) {
-            var iter = std.mem.splitAny(u8, line[3..], " ");
-            const x = try std.fmt.parseFloat(f32, iter.next() orelse return error.InvalidLine);
-            const y = try std.fmt.parseFloat(f32, iter.next() orelse return error.InvalidLine);
-
-            try textureCoords.append(Vector2{ .x = x, .y = y });
-        } else if (line.len >= 2 and std.mem.eql(u8, line[0..2], "f ")) {
-            // format is `f 0/0/0 1/1/1 2/2/2`
-            try readFace(line[2..], &faces, vertices.items.len, normals.items.len, textureCoords.items.len);
+/// Deduplicate the corners of `faces` into `vertexBuffer` and `indexBuffer`, replacing them.
+/// Without texture coordinates, the UVs fall back to a planar mapping on the YZ plane.
+/// Only for meshes owning their arrays, cached meshes are mapped with their buffers.
+pub fn buildVertexBuffer(self: *Mesh) !void {
+    std.debug.assert(self.mapping == null);
+
+    const has_uv = self.textureCoords.len > 1;
+
+    var index_buffer = try ArrayList(u32).initCapacity(self.allocator, self.faces.len * 3);
+    defer index_buffer.deinit();
+    // Most corners share their position and attributes with their neighbours, expect about one per position.
+    var vertex_buffer = try ArrayList(Vertex).initCapacity(self.allocator, self.vertices.len);
+    defer vertex_buffer.deinit();
+
+    var corners = std.AutoHashMap([3]u32, u32).init(self.allocator);
+    defer corners.deinit();
+    try corners.ensureTotalCapacity(@intCast(self.vertices.len));
+
+    for (self.faces) |face| {
+        for (face.vertices, face.textures, face.normals) |v, vt, vn| {
+            const entry = try corners.getOrPut(.{ v, vt, vn });
+            if (!entry.found_existing) {
+                const position = self.vertices[v];
+                entry.value_ptr.* = @intCast(vertex_buffer.items.len);
+                try vertex_buffer.append(.{
+                    .position = position,
+                    .uv = if (has_uv) self.textureCoords[vt] else position.yz(),
+                    .normal = self.normals[vn],
+                });
+            }
+            index_buffer.appendAssumeCapacity(entry.value_ptr.*);
         }
     }
 
-    if (textureCoords.items.len == 0) {
-        try textureCoords.append(Vector2{});
-    }
+    const vertices = try vertex_buffer.toOwnedSlice();
+    errdefer self.allocator.free(vertices);
+    const indices = try index_buffer.toOwnedSlice();
 
-    if (normals.items.len == 0) {
-        try normals.append(Vector3{});
-    }
-
-    return Mesh{
-        .vertices = vertices,
-        .textureCoords = textureCoords,
-        .normals = normals,
-        .faces = faces,
-        .allocator = gpa,
-    };
+    self.allocator.free(self.vertexBuffer);
+    self.allocator.free(self.indexBuffer);
+    self.vertexBuffer = vertices;
+    self.indexBuffer = indices;
 }
 
 pub const Box = struct {
@@ -158,14 +128,14 @@ pub const Box = struct {
 };
 
 pub fn getBounds(self: *const Mesh) Box {
-    if (self.vertices.items.len == 0) {
+    if (self.vertices.len == 0) {
         return .{ .min = .{}, .max = .{} };
     }
 
-    var min = self.vertices.items[0];
-    var max = self.vertices.items[0];
+    var min = self.vertices[0];
+    var max = self.vertices[0];
 
-    for (self.vertices.items) |vertex| {
+    for (self.vertices) |vertex| {
         if (vertex.x < min.x) {
             min.x = vertex.x;
         }
@@ -197,8 +167,15 @@ pub fn getMiddlePoint(self: *const Mesh) Vector3 {
 }
 
 pub fn deinit(self: *const Mesh) void {
-    self.vertices.deinit();
-    self.textureCoords.deinit();
-    self.normals.deinit();
-    self.faces.deinit();
+    if (self.mapping) |mapping| {
+        std.posix.munmap(mapping);
+        return;
+    }
+
+    self.allocator.free(self.vertices);
+    self.allocator.free(self.textureCoords);
+    self.allocator.free(self.normals);
+    self.allocator.free(self.faces);
+    self.allocator.free(self.vertexBuffer);
+    self.allocator.free(self.indexBuffer);
 }
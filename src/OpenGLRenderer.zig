@@ -26,7 +26,7 @@ pub fn init(allocator: Allocator, settings_: Settings, mesh_: Mesh, texture_: ?T
     return .{ .allocator = allocator };
 }
 
-pub fn run(self: *const @This()) !void {
+pub fn run(_: *const @This()) !void {
     if (!c.SDL_Init(c.SDL_INIT_VIDEO | c.SDL_INIT_EVENTS)) {
         return error.UnableToInitialize;
     }
@@ -56,14 +56,8 @@ pub fn run(self: *const @This()) !void {
 
     // Create the vertex buffer
 
-    var indices = try std.ArrayList(u32).initCapacity(self.allocator, mesh.faces.items.len * 3);
-    defer indices.deinit();
-
-    for (mesh.faces.items) |face| {
-        try indices.append(face.vertices[0]);
-        try indices.append(face.vertices[1]);
-        try indices.append(face.vertices[2]);
-    }
+    const vertices = mesh.vertexBuffer;
+    const indices = mesh.indexBuffer;
 
     var vao: c.GLuint = undefined;
     c.glGenVertexArrays(1, &vao);
@@ -72,15 +66,21 @@ pub fn run(self: *const @This()) !void {
     var vbo: c.GLuint = undefined;
     c.glGenBuffers(1, &vbo);
     c.glBindBuffer(c.GL_ARRAY_BUFFER, vbo);
-    c.glBufferData(c.GL_ARRAY_BUFFER, @intCast(@sizeOf(f32) * mesh.vertices.items.len), @ptrCast(mesh.vertices.items.ptr), c.GL_STATIC_DRAW);
-
-    c.glVertexAttribPointer(0, 3, c.GL_FLOAT, c.GL_FALSE, 3 * @sizeOf(f32), null);
-    c.glEnableVertexAttribArray(0);
+    c.glBufferData(c.GL_ARRAY_BUFFER, @intCast(@sizeOf(Mesh.Vertex) * vertices.len), @ptrCast(vertices.ptr), c.GL_STATIC_DRAW);
+
+    // Attributes are interleaved, in the order of the shader locations. The UVs are skipped, this renderer
+    // does not texture the mesh.
+    inline for (.{ "position", "normal" }, 0..) |field, location| {
+        const size = @sizeOf(@FieldType(Mesh.Vertex, field)) / @sizeOf(f32);
+        const offset: ?*const anyopaque = @ptrFromInt(@offsetOf(Mesh.Vertex, field));
+        c.glVertexAttribPointer(location, size, c.GL_FLOAT, c.GL_FALSE, @sizeOf(Mesh.Vertex), offset);
+        c.glEnableVertexAttribArray(location);
+    }
 
     var ebo: c.GLuint = undefined;
     c.glGenBuffers(1, &ebo);
     c.glBindBuffer(c.GL_ELEMENT_ARRAY_BUFFER, ebo);
-    c.glBufferData(c.GL_ELEMENT_ARRAY_BUFFER, @intCast(@sizeOf(u32) * indices.items.len), @ptrCast(indices.items.ptr), c.GL_STATIC_DRAW);
+    c.glBufferData(c.GL_ELEMENT_ARRAY_BUFFER, @intCast(@sizeOf(u32) * indices.len), @ptrCast(indices.ptr), c.GL_STATIC_DRAW);
 
     // Compile & Link shaders
     const vertex_shader = c.glCreateShader(c.GL_VERTEX_SHADER);
@@ -132,7 +132,7 @@ pub fn run(self: *const @This()) !void {
         c.glBindBuffer(c.GL_ARRAY_BUFFER, vbo);
         c.glBindBuffer(c.GL_ELEMENT_ARRAY_BUFFER, ebo);
 
-        c.glDrawElements(c.GL_TRIANGLES, @intCast(indices.items.len), c.GL_UNSIGNED_INT, null);
+        c.glDrawElements(c.GL_TRIANGLES, @intCast(indices.len), c.GL_UNSIGNED_INT, null);
 
         _ = c.SDL_GL_SwapWindow(window);
     }
@@ -145,8 +145,10 @@ const vertex_shader_source: []const u8 =
     \\  #version 330 core
     \\
     \\  layout(location = 0) in vec3 aPos;
+    \\  layout(location = 1) in vec3 aNormal;
     \\
     \\  out vec4 vertexColor;
+    \\  out vec3 normal;
     \\
     \\  uniform mat4 modelMatrix;
     \\  uniform mat4 viewMatrix;
@@ -158,6 +160,7 @@ const vertex_shader_source: []const u8 =
     \\
     \\      gl_Position = mvp * vec4(aPos, 1.0);
     \\      vertexColor = vec4(0.5, 0.0, 0.0, 1.0);
+    \\      normal = mat3(modelMatrix) * aNormal;
     \\  }
 ;
 
@@ -165,11 +168,18 @@ const fragment_shader_source: []const u8 =
     \\  #version 330 core
     \\
     \\  in vec4 vertexColor;
+    \\  in vec3 normal;
     \\
     \\  out vec4 fragColor;
     \\
     \\  void main()
     \\  {
-    \\      fragColor = vertexColor;
+    \\      // Meshes without normals are left unlit.
+    \\      float light = 1.0;
+    \\      if (dot(normal, normal) > 0.0) {
+    \\          light = 0.3 + 0.7 * max(dot(normalize(normal), normalize(vec3(0.5, 1.0, 1.0))), 0.0);
+    \\      }
+    \\
+    \\      fragColor = vec4(vertexColor.rgb * light, vertexColor.a);
     \\  }
 ;
@@ -1,10 +1,24 @@
 pub const RenderMode = enum {
     color,
     texture,
+    /// Software renderer only, pixels colored by how many fragments were shaded there, from blue to red.
+    /// With `render_prepass` or `visibility_buffer`, which shade each pixel once, by how many fragments
+    /// passed the depth test there instead.
+    overdraw,
+    /// Software renderer only, tiles tinted by their raster time relative to the slowest tile, from blue to red.
+    cost,
+};
+
+pub const SoftwareBackend = enum {
+    /// MiniLibX window, presented through MIT-SHM.
+    mlx,
+    /// SDL window, presented through a streaming texture.
+    sdl,
 };
 
 enable_rotation: bool = true,
 render_mode: RenderMode = .texture,
+/// Rotation in radians of one 60 Hz animation step, independent of `frame_rate`.
 rotation_speed: f32 = 0.01,
 model_x: f32 = 0.0,
 model_y: f32 = 1.0,
@@ -13,3 +27,25 @@ fov: f32 = 60.0,
 move_speed: f32 = 0.2,
 window_width: usize = 1280,
 window_height: usize = 720,
+/// Number of threads rasterizing tiles, `0` uses every available core.
+thread_count: usize = 0,
+/// Size in pixels of the square screen tiles triangles are binned into, rounded up to a multiple of the SIMD width.
+tile_size: usize = 64,
+/// Defer shading until the visible triangle of every pixel is known, so each pixel is shaded once.
+visibility_buffer: bool = false,
+/// Rasterize depth only before shading, so each pixel is shaded by its visible triangle only.
+render_prepass: bool = false,
+/// Coarsely sort triangles front to back before rasterizing them, so hidden fragments fail the depth test early.
+sort_triangles: bool = false,
+/// Clear tiles only when something is drawn in them, untouched tiles are filled when presenting.
+lazy_clear: bool = true,
+/// Frames per second, `0` renders as fast as possible.
+frame_rate: u32 = 60,
+/// Window system used by the software renderer.
+software_backend: SoftwareBackend = .mlx,
+/// Draw the time of every profiled stage over the frame, only in builds with `-Dprofile=true`.
+profile_overlay: bool = false,
+/// File the frame time percentiles are regularly written to in the Prometheus text format, `null` disables it.
+telemetry_path: ?[]const u8 = null,
+/// Seconds between two writes of `telemetry_path`.
+telemetry_interval: u32 = 15,
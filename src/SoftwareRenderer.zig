@@ -1,6 +1,8 @@
 const std = @import("std");
 const math = @import("math.zig");
 const mlx = @import("mlx");
+const profile = @import("profile.zig");
+const parallel = @import("parallel.zig");
 
 const Allocator = std.mem.Allocator;
 const Matrix4 = math.Matrix4;
@@ -10,8 +12,8 @@ const Vector4 = math.Vector4;
 const Mesh = @import("Mesh.zig");
 const Texture = @import("Texture.zig");
 const Settings = @import("Settings.zig");
-
-// TODO: Use SDL instead of MLX
+const FramePacer = @import("FramePacer.zig");
+const Telemetry = @import("Telemetry.zig");
 
 allocator: Allocator,
 
@@ -19,95 +21,251 @@ var the_mesh: Mesh = undefined;
 var the_texture: ?Texture = undefined;
 var settings: Settings = undefined;
 var gfx: Graphics = undefined;
-var last_update: i64 = 0;
-const time_between_frame = 1_000_000 / 60; // 60 frame per seconds
+var frame_pacer: FramePacer = undefined;
+/// The model is animated in fixed steps, `rotation_speed` is the rotation of one step.
+const simulation_step = std.time.ns_per_s / 60;
+/// Longest time simulated in one frame, a stalled frame skips the rest.
+const max_simulation_lag = std.time.ns_per_s / 4;
+var simulation_time: u64 = 0;
 var rotation_y: f32 = 0.0;
+var total_stats: Graphics.Statistics = .{};
+var telemetry: Telemetry = undefined;
+/// End of the previous `present`, on the pacer's clock.
+var last_present_end: u64 = 0;
+
+/// Keys handled by the viewer, whatever the window system.
+const Key = enum {
+    f1,
+    space,
+    left,
+    right,
+    up,
+    down,
+    shift,
+    control,
+};
 
 pub fn init(allocator: Allocator, settings_: Settings, mesh_: Mesh, texture_: ?Texture) @This() {
     settings = settings_;
     the_mesh = mesh_;
     the_texture = texture_;
+    telemetry = Telemetry.init(settings.telemetry_path, settings.telemetry_interval);
     return .{
         .allocator = allocator,
     };
 }
 
 pub fn run(self: *const @This()) !void {
+    switch (settings.software_backend) {
+        .mlx => try self.runMlx(),
+        .sdl => try self.runSdl(),
+    }
+
+    std.log.info("pipeline statistics: {}", .{total_stats});
+    std.log.info("fragments: {} passed the depth test, {} shaded, {} saved", .{
+        total_stats.depth_passes,
+        total_stats.fragments_shaded,
+        total_stats.fragmentsSaved(),
+    });
+    telemetry.report();
+}
+
+fn runMlx(self: *const @This()) !void {
     const mlx_ptr = mlx.mlx_init() orelse std.debug.panic("unable to initialize mlx", .{});
     defer _ = mlx.mlx_destroy_display(mlx_ptr);
 
     const win_ptr = mlx.mlx_new_window(mlx_ptr, @intCast(settings.window_width), @intCast(settings.window_height), @ptrCast(@constCast("scop"))) orelse std.debug.panic("unable to create the window", .{});
     defer _ = mlx.mlx_destroy_window(mlx_ptr, win_ptr);
 
-    gfx = Graphics.init(mlx_ptr, win_ptr, settings.window_width, settings.window_height, self.allocator) catch std.debug.panic("unable to initialize graphics", .{});
-    gfx.render_mode = settings.render_mode;
-
-    const view = Matrix4.translation(.{ .x = 0.0, .y = 0.0, .z = 0.0 });
-    const proj = Matrix4.projection(settings.fov, settings.window_width, settings.window_height, 0.001, 1000.0);
+    try self.initGraphics(.{ .mlx = .{ .mlx_ptr = mlx_ptr, .win_ptr = win_ptr } });
+    defer gfx.deinit();
 
-    gfx.loadViewMatrix(view);
-    gfx.loadProjectionMatrix(proj);
+    // Let the loop sleep in poll() until the next frame, the pacer then only keeps the time.
+    // Fallback to sleeping in `tick` when no timer can be created.
+    const loop_paced = settings.frame_rate != 0 and
+        mlx.mlx_loop_timer(mlx_ptr, @intCast(std.time.ns_per_s / settings.frame_rate)) != 0;
+    frame_pacer = FramePacer.init(if (loop_paced) 0 else settings.frame_rate) catch std.debug.panic("unable to start the frame timer", .{});
 
     _ = mlx.mlx_hook(win_ptr, mlx.DestroyNotify, 0, @ptrCast(&onDestroyNotify), null);
+    _ = mlx.mlx_expose_hook(win_ptr, @ptrCast(&onExpose), null);
     _ = mlx.mlx_hook(win_ptr, mlx.KeyPress, mlx.KeyPressMask, @ptrCast(&onKeyPress), null);
     _ = mlx.mlx_loop_hook(mlx_ptr, @ptrCast(&tick), null);
     _ = mlx.mlx_loop(mlx_ptr);
 }
 
-fn tick(_: ?*anyopaque) callconv(.c) void {
-    // Limit frame per seconds.
-    // TODO: Find a better way, for example waiting for a v-blank or else the CPU will be busy !
-    const current_time = std.time.microTimestamp();
+/// Present through an SDL streaming texture, paced by vsync when available.
+/// Works with any SDL video driver, including `SDL_VIDEO_DRIVER=offscreen` or `dummy` on headless machines.
+fn runSdl(self: *const @This()) !void {
+    if (!mlx.SDL_Init(mlx.SDL_INIT_VIDEO | mlx.SDL_INIT_EVENTS)) {
+        return error.UnableToInitialize;
+    }
+    defer mlx.SDL_Quit();
+
+    const window = mlx.SDL_CreateWindow("scop", @intCast(settings.window_width), @intCast(settings.window_height), 0) orelse
+        return error.UnableToCreateWindow;
+    defer mlx.SDL_DestroyWindow(window);
+
+    const renderer = mlx.SDL_CreateRenderer(window, null) orelse return error.UnableToCreateRenderer;
+    defer mlx.SDL_DestroyRenderer(renderer);
+
+    try self.initGraphics(.{ .sdl = renderer });
+    defer gfx.deinit();
+
+    // Presenting blocks until the next vertical blank, the pacer then only keeps the time.
+    const vsync = settings.frame_rate != 0 and mlx.SDL_SetRenderVSync(renderer, 1);
+    frame_pacer = FramePacer.init(if (vsync) 0 else settings.frame_rate) catch std.debug.panic("unable to start the frame timer", .{});
+
+    var running = true;
+    while (running) {
+        var event: mlx.SDL_Event = undefined;
+
+        while (mlx.SDL_PollEvent(&event)) {
+            if (event.type == mlx.SDL_EVENT_WINDOW_CLOSE_REQUESTED or event.type == mlx.SDL_EVENT_QUIT) {
+                running = false;
+            } else if (event.type == mlx.SDL_EVENT_WINDOW_EXPOSED) {
+                gfx.invalidate();
+            } else if (event.type == mlx.SDL_EVENT_KEY_DOWN) {
+                const key: ?Key = switch (event.key.key) {
+                    mlx.SDLK_F1 => .f1,
+                    mlx.SDLK_SPACE => .space,
+                    mlx.SDLK_LEFT => .left,
+                    mlx.SDLK_RIGHT => .right,
+                    mlx.SDLK_UP => .up,
+                    mlx.SDLK_DOWN => .down,
+                    mlx.SDLK_LSHIFT => .shift,
+                    mlx.SDLK_LCTRL => .control,
+                    else => null,
+                };
+                if (key) |k| onKey(k);
+            }
+        }
 
-    if (current_time - last_update < time_between_frame) {
-        return;
+        tick(null);
+    }
+}
+
+fn initGraphics(self: *const @This(), output: Graphics.Output) !void {
+    gfx = try Graphics.init(output, settings.window_width, settings.window_height, self.allocator, .{
+        .tile_size = settings.tile_size,
+        .thread_count = settings.thread_count,
+    });
+    gfx.configure(settings);
+}
+
+fn tick(_: ?*anyopaque) callconv(.c) void {
+    // Sleep until the next frame instead of polling the clock, unless the loop already did.
+    const wait_zone = profile.begin("wait");
+    frame_pacer.wait();
+    wait_zone.end();
+
+    // Advance the animation independently of the frame rate.
+    const now = frame_pacer.elapsed();
+    if (now - simulation_time > max_simulation_lag) {
+        simulation_time = now - max_simulation_lag;
+    }
+    while (now - simulation_time >= simulation_step) : (simulation_time += simulation_step) {
+        if (settings.enable_rotation) {
+            rotation_y += settings.rotation_speed;
+        }
     }
-    last_update = current_time;
 
     // const model = Matrix4.model(.{ .x = settings.model_x, .y = settings.model_y, .z = settings.model_z }, .{ .x = 0.0, .y = rotation_y, .z = 0.0 });
     // gfx.loadModelMatrix(model);
 
+    const frame_start = frame_pacer.elapsed();
+
+    const clear_zone = profile.begin("clear");
     gfx.clear();
+    clear_zone.end();
+
+    const draw_zone = profile.begin("draw");
     gfx.draw(&the_mesh, .{
         .texture = the_texture,
         .position = .{ .x = settings.model_x, .y = settings.model_y, .z = settings.model_z },
         .rotation = .{ .y = rotation_y },
         .offset = the_mesh.getMiddlePoint(),
-    });
+    }) catch |err| {
+        std.log.err("unable to draw the mesh: {}", .{err});
+    };
+    draw_zone.end();
+    const draw_end = frame_pacer.elapsed();
+
+    const present_zone = profile.begin("present");
     gfx.present();
+    present_zone.end();
+    const present_end = frame_pacer.elapsed();
 
-    if (settings.enable_rotation) {
-        rotation_y += settings.rotation_speed;
+    // The present time of a frame includes the wait before it, in `tick` or in the loop.
+    if (last_present_end != 0) {
+        telemetry.record(draw_end - frame_start, present_end - draw_end + (frame_start - last_present_end), present_end);
     }
+    last_present_end = present_end;
+
+    total_stats.add(gfx.stats);
+
+    if (profile.enabled and settings.profile_overlay and gfx.output == .mlx) {
+        drawProfileOverlay();
+    }
+}
+
+/// Write the time spent in every zone since the previous frame in the top left corner of the window.
+/// Zones running on the tile threads are summed over every thread.
+fn drawProfileOverlay() void {
+    const line_height = 15;
+    const window = gfx.output.mlx;
+
+    var buffer: [16]profile.Total = undefined;
+    const totals = profile.frameTotals(&buffer);
+
+    for (totals, 0..) |total, i| {
+        var line_buffer: [64]u8 = undefined;
+        const line = std.fmt.bufPrintZ(&line_buffer, "{s}: {d:.2} ms", .{
+            total.name,
+            @as(f64, @floatFromInt(total.duration)) / std.time.ns_per_ms,
+        }) catch continue;
+        _ = mlx.mlx_string_put(window.mlx_ptr, window.win_ptr, 10, @intCast(20 + i * line_height), 0xffffff, line.ptr);
+    }
+
+    // The text is drawn over the window, the next frame has to overwrite it.
+    gfx.invalidateArea(0, 0, 200, 20 + totals.len * line_height);
 }
 
 fn onDestroyNotify(_: ?*anyopaque) callconv(.c) void {
-    _ = mlx.mlx_loop_end(gfx.mlx_ptr);
+    _ = mlx.mlx_loop_end(gfx.output.mlx.mlx_ptr);
+}
+
+fn onExpose(_: ?*anyopaque) callconv(.c) void {
+    gfx.invalidate();
 }
 
 fn onKeyPress(keycode: c_int, _: ?*anyopaque) callconv(.c) void {
-    if (keycode == mlx.XK_F1) {
-        if (gfx.render_mode == .color) {
-            gfx.render_mode = .texture;
-        } else {
-            gfx.render_mode = .color;
-        }
-    }
+    const key: Key = switch (keycode) {
+        mlx.XK_F1 => .f1,
+        mlx.XK_space => .space,
+        mlx.XK_Left => .left,
+        mlx.XK_Right => .right,
+        mlx.XK_Up => .up,
+        mlx.XK_Down => .down,
+        mlx.XK_Shift_L => .shift,
+        mlx.XK_Control_L => .control,
+        else => return,
+    };
+    onKey(key);
+}
 
-    if (keycode == mlx.XK_space) {
-        settings.enable_rotation = !settings.enable_rotation;
-    } else if (keycode == mlx.XK_Left) {
-        settings.model_x -= settings.move_speed;
-    } else if (keycode == mlx.XK_Right) {
-        settings.model_x += settings.move_speed;
-    } else if (keycode == mlx.XK_Up) {
-        settings.model_y += settings.move_speed;
-    } else if (keycode == mlx.XK_Down) {
-        settings.model_y -= settings.move_speed;
-    } else if (keycode == mlx.XK_Shift_L) {
-        settings.model_z -= settings.move_speed;
-    } else if (keycode == mlx.XK_Control_L) {
-        settings.model_z += settings.move_speed;
+fn onKey(key: Key) void {
+    switch (key) {
+        .f1 => {
+            const mode_count = @typeInfo(Settings.RenderMode).@"enum".fields.len;
+            gfx.render_mode = @enumFromInt((@intFromEnum(gfx.render_mode) + 1) % mode_count);
+        },
+        .space => settings.enable_rotation = !settings.enable_rotation,
+        .left => settings.model_x -= settings.move_speed,
+        .right => settings.model_x += settings.move_speed,
+        .up => settings.model_y += settings.move_speed,
+        .down => settings.model_y -= settings.move_speed,
+        .shift => settings.model_z -= settings.move_speed,
+        .control => settings.model_z += settings.move_speed,
     }
 }
 
@@ -154,22 +312,407 @@ pub const Graphics = struct {
         }
     };
 
-    mlx_ptr: ?*anyopaque,
-    win_ptr: ?*anyopaque,
+    /// Number of pixels shaded at once, 8 with AVX2 and 4 with SSE.
+    const lanes = std.simd.suggestVectorLength(f32) orelse 4;
+    const FloatLanes = @Vector(lanes, f32);
+    const IndexLanes = @Vector(lanes, usize);
+    const ColorLanes = @Vector(lanes, u32);
+    const MaskLanes = @Vector(lanes, bool);
+    const EdgeLanes = @Vector(lanes, i64);
+    const IdLanes = @Vector(lanes, u32);
+    const CountLanes = @Vector(lanes, u8);
+
+    /// Marks pixels of the visibility buffer not covered by the current `draw`.
+    const no_triangle = std.math.maxInt(u32);
+    /// Number of canvases presented in turn.
+    const canvas_count = 2;
+
+    /// Side in pixels of the square blocks tracked by the hierarchical depth buffer.
+    const hiz_block_size = @max(8, lanes);
+    const HiZRow = @Vector(hiz_block_size, f32);
+
+    /// Vertices are snapped to a grid of `1 / (1 << sub_pixel_bits)` pixels before edge setup.
+    const sub_pixel_bits = 8;
+    const sub_pixel_scale: f32 = 1 << sub_pixel_bits;
+
+    /// A fixed-point edge function, evaluated at pixel centers and stepped with integer adds.
+    const Edge = struct {
+        /// Value at the center of the first pixel of the triangle's bounding box, its lowest `x` and `y`.
+        /// Already biased by the fill rule, so a pixel is covered when every edge is `>= 0`.
+        origin: i64,
+        step_x: i64,
+        step_y: i64,
+
+        /// Setup the edge going from `a` to `b`, coordinates are in sub-pixels.
+        fn init(ax: i64, ay: i64, bx: i64, by: i64, px: i64, py: i64) Edge {
+            const step_x = ay - by;
+            const step_y = bx - ax;
+
+            // Top-left fill rule: pixels lying exactly on an edge belong to a triangle only if that edge is a
+            // left edge, with the interior towards `+x`, or a horizontal top edge on screen. Raster rows go
+            // upward, so a top edge has the interior towards `-y`. The two triangles sharing an edge see it in
+            // opposite directions, so exactly one of them draws those pixels.
+            const top_left = step_x > 0 or (step_x == 0 and step_y < 0);
+            const bias: i64 = if (top_left) 0 else -1;
+
+            return .{
+                .origin = (ax - px) * (by - py) - (ay - py) * (bx - px) + bias,
+                .step_x = step_x << sub_pixel_bits,
+                .step_y = step_y << sub_pixel_bits,
+            };
+        }
+    };
+
+    inline fn snap(v: f32) i64 {
+        return @intFromFloat(@round(v * sub_pixel_scale));
+    }
+
+    /// Triangles are clipped where their clip space `z` goes below this value.
+    const near_plane: f32 = 0.1;
+    /// Triangles partly off-screen are rasterized with a clamped bounding box as long as they stay within
+    /// this many pixels around the screen. Only triangles going further are clipped, which keeps the
+    /// fixed-point edge functions from overflowing.
+    const guard_band: f32 = 1 << 14;
+
+    /// Planes a vertex can be outside of, as bits of `TransformedVertex.flags`.
+    const ClipPlane = enum(u3) { near, left, right, bottom, top };
+    const clip_plane_count = @typeInfo(ClipPlane).@"enum".fields.len;
+    /// Every plane a triangle is clipped against can add one vertex.
+    const max_clip_vertices = 3 + clip_plane_count;
+
+    const FlagLanes = @Vector(lanes, u8);
+
+    /// A triangle corner going through clipping, with everything needed to interpolate it along an edge.
+    const ClipVertex = struct {
+        position: Vector4,
+        ndc: Vector2,
+        uv: Vector2,
+        normal: Vector3,
+
+        fn lerp(a: ClipVertex, b: ClipVertex, t: f32) ClipVertex {
+            const position = a.position.add(b.position.add(a.position.scale(-1.0)).scale(t));
+
+            return .{
+                .position = position,
+                .ndc = .{ .x = position.x / position.w, .y = position.y / position.w },
+                .uv = a.uv.add(b.uv.sub(a.uv).scale(t)),
+                .normal = a.normal.add(b.normal.sub(a.normal).scale(t)),
+            };
+        }
+    };
+
+    /// Signed distance of a clip space position to a plane, negative when outside.
+    inline fn planeDistance(comptime plane: ClipPlane, p: Vector4, guard: Vector2) f32 {
+        return switch (plane) {
+            .near => p.z - near_plane,
+            .left => p.x + guard.x * p.w,
+            .right => guard.x * p.w - p.x,
+            .bottom => p.y + guard.y * p.w,
+            .top => guard.y * p.w - p.y,
+        };
+    }
+
+    /// Clip a triangle against every plane in `planes` (Sutherland-Hodgman), returns the number of
+    /// vertices of the resulting convex polygon, less than 3 when nothing is left. `emptied_by` is then
+    /// set to the plane that removed what was left.
+    fn clipTriangle(
+        corners: [3]ClipVertex,
+        planes: u8,
+        guard: Vector2,
+        out: *[max_clip_vertices]ClipVertex,
+        emptied_by: *ClipPlane,
+    ) usize {
+        var buffers: [2][max_clip_vertices]ClipVertex = undefined;
+        buffers[0][0..3].* = corners;
+        var count: usize = 3;
+        var src: usize = 0;
+
+        inline for (0..clip_plane_count) |plane_index| {
+            const plane: ClipPlane = @enumFromInt(plane_index);
+
+            if ((planes & (1 << plane_index)) != 0) {
+                const input = &buffers[src];
+                const dst = &buffers[1 - src];
+                var n: usize = 0;
+
+                for (0..count) |i| {
+                    const a = input[i];
+                    const b = input[(i + 1) % count];
+                    const da = planeDistance(plane, a.position, guard);
+                    const db = planeDistance(plane, b.position, guard);
+
+                    if (da >= 0.0) {
+                        dst[n] = a;
+                        n += 1;
+                    }
+                    if ((da >= 0.0) != (db >= 0.0)) {
+                        dst[n] = ClipVertex.lerp(a, b, da / (da - db));
+                        n += 1;
+                    }
+                }
+
+                count = n;
+                src = 1 - src;
+
+                if (count < 3) {
+                    emptied_by.* = plane;
+                    return 0;
+                }
+            }
+        }
+
+        out.* = buffers[src];
+        return count;
+    }
+
+    inline fn planeBit(comptime plane: ClipPlane) u8 {
+        return 1 << @intFromEnum(plane);
+    }
+
+    inline fn planeFlag(comptime plane: ClipPlane, outside: MaskLanes) FlagLanes {
+        return @select(u8, outside, @as(FlagLanes, @splat(planeBit(plane))), @as(FlagLanes, @splat(0)));
+    }
+
+    /// Sign of the screen space winding, only front faces are drawn.
+    inline fn isFrontFacing(a: Vector2, b: Vector2, c: Vector2) bool {
+        return (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x) >= 0.0;
+    }
+
+    /// A vertex after the vertex stage, stored as structure-of-arrays in `vertex_cache`.
+    const TransformedVertex = struct {
+        /// Clip space position, before the perspective divide.
+        x: f32,
+        y: f32,
+        z: f32,
+        w: f32,
+        /// Normalized device coordinates.
+        ndc_x: f32,
+        ndc_y: f32,
+        /// Bit set of the `ClipPlane` the vertex is outside of.
+        flags: u8,
+    };
+
+    /// A triangle after setup, in raster space and ready to be rasterized by any tile it overlaps.
+    const Triangle = struct {
+        /// Raster space positions, `z` holds the inverse depth.
+        /// Coverage only uses `edges`, positions are kept for depth and attribute interpolation.
+        v0: Vector3,
+        v1: Vector3,
+        v2: Vector3,
+        /// Texture coordinates and normals, already divided by their vertex depth.
+        t0: Vector2,
+        t1: Vector2,
+        t2: Vector2,
+        n0: Vector3,
+        n1: Vector3,
+        n2: Vector3,
+        /// Edges opposite to `v0`, `v1` and `v2`, their values are the unnormalized barycentric weights.
+        edges: [3]Edge,
+        /// Inverse of the fixed-point doubled area.
+        inv_area: f32,
+        /// Range of the depth values written by the triangle, used to test it against the hierarchical depth buffer.
+        depth_min: f32,
+        depth_max: f32,
+        /// Bounding box clamped to the screen, `max_x` and `max_y` are exclusive.
+        min_x: usize,
+        min_y: usize,
+        max_x: usize,
+        max_y: usize,
+        face_index: usize,
+
+        /// Evaluate the edge functions directly at a row of pixels.
+        inline fn edgesAt(tri: *const Triangle, xs: IndexLanes, y: usize) [3]EdgeLanes {
+            const dx = @as(EdgeLanes, @intCast(xs)) - @as(EdgeLanes, @splat(@as(i64, @intCast(tri.min_x))));
+            const dy = @as(i64, @intCast(y)) - @as(i64, @intCast(tri.min_y));
+            var edges: [3]EdgeLanes = undefined;
+
+            inline for (0..3) |i| {
+                const edge = tri.edges[i];
+                edges[i] = @as(EdgeLanes, @splat(edge.origin + edge.step_y * dy)) + dx * @as(EdgeLanes, @splat(edge.step_x));
+            }
+
+            return edges;
+        }
+    };
+
+    /// Screen rectangle in raster space, `max_x` and `max_y` are exclusive.
+    const Rect = struct {
+        min_x: usize,
+        min_y: usize,
+        max_x: usize,
+        max_y: usize,
+
+        const empty = Rect{ .min_x = std.math.maxInt(usize), .min_y = std.math.maxInt(usize), .max_x = 0, .max_y = 0 };
 
-    // The MiniLibX image used as a buffer.
-    canvas: ?*mlx.t_img,
+        fn isEmpty(r: Rect) bool {
+            return r.min_x >= r.max_x or r.min_y >= r.max_y;
+        }
+
+        fn merge(a: Rect, b: Rect) Rect {
+            return .{
+                .min_x = @min(a.min_x, b.min_x),
+                .min_y = @min(a.min_y, b.min_y),
+                .max_x = @max(a.max_x, b.max_x),
+                .max_y = @max(a.max_y, b.max_y),
+            };
+        }
+    };
+
+    /// Pipeline counters, like OpenGL's pipeline statistics queries.
+    /// Geometry counters are filled by `draw`, raster counters by every tile job in its own copy, merged once
+    /// the tiles are done. With the pre-pass, raster counters only count the depth pass.
+    ///
+    /// Every submitted face has exactly one outcome: `faces_submitted` is the sum of `backface_culled`,
+    /// `near_rejected`, `offscreen_rejected` and `faces_set_up`.
+    pub const Statistics = struct {
+        /// Faces of the meshes drawn.
+        faces_submitted: u64 = 0,
+        /// Back facing faces, or degenerate once snapped to the sub-pixel grid.
+        backface_culled: u64 = 0,
+        /// Faces entirely behind the near plane, or clipped away by it.
+        near_rejected: u64 = 0,
+        /// Faces entirely outside of the guard band or the screen, or clipped away by a guard band plane.
+        offscreen_rejected: u64 = 0,
+        /// Faces with at least one triangle set up, and so binned.
+        faces_set_up: u64 = 0,
+        /// Triangles the clipped faces were split into, whatever became of them.
+        clipped_triangles: u64 = 0,
+        /// Pixels of the bounding boxes the edge functions were evaluated at, hierarchical depth rejects excluded.
+        bbox_pixels_tested: u64 = 0,
+        /// Pixels inside a triangle.
+        pixels_covered: u64 = 0,
+        /// Fragments passing the depth test in binning order, what forward shading without a pre-pass
+        /// would shade. Compare `fragments_shaded` with and without `sort_triangles` to see what ordering saves.
+        depth_passes: u64 = 0,
+        /// Covered pixels failing the depth test.
+        depth_fails: u64 = 0,
+        /// Fragments actually run through `fragmentShader`.
+        fragments_shaded: u64 = 0,
+
+        pub fn add(self: *Statistics, other: Statistics) void {
+            inline for (std.meta.fields(Statistics)) |field| {
+                @field(self, field.name) += @field(other, field.name);
+            }
+        }
+
+        /// Shaded fragments avoided by the pre-pass or the visibility buffer.
+        pub fn fragmentsSaved(self: Statistics) u64 {
+            return self.depth_passes -| self.fragments_shaded;
+        }
+
+        /// Every counter as `name value` pairs.
+        pub fn format(self: Statistics, comptime _: []const u8, _: std.fmt.FormatOptions, writer: anytype) !void {
+            inline for (std.meta.fields(Statistics), 0..) |field, i| {
+                try writer.print("{s}{s} {}", .{ if (i == 0) "" else ", ", field.name, @field(self, field.name) });
+            }
+        }
+    };
+
+    /// What a pass over the bin of a tile writes.
+    const RasterPass = enum {
+        /// Depth only, the pre-pass.
+        depth,
+        /// Depth and color, or triangle IDs with `visibility_buffer`.
+        full,
+        /// Color, or triangle IDs, of the fragments matching the depth left by the pre-pass.
+        shade,
+    };
+
+    /// Where `present` sends the frames.
+    pub const Output = union(enum) {
+        /// A MiniLibX window.
+        mlx: struct {
+            mlx_ptr: ?*anyopaque,
+            win_ptr: ?*anyopaque,
+        },
+        /// An SDL renderer, frames are written into a streaming texture it owns.
+        sdl: *mlx.SDL_Renderer,
+        /// A framebuffer in memory, read with `framebuffer`.
+        memory,
+    };
+
+    /// Destination of `resolveTile`, a window space rectangle of pixels with rows stored top-down.
+    const ResolveTarget = struct {
+        pixels: [*]Color,
+        /// Distance in pixels between two rows.
+        stride: usize,
+        /// Window position of `pixels[0]`.
+        x: usize,
+        y: usize,
+        /// For each tile, whether the target already holds `canvas_clear_color` there.
+        /// `null` when the previous content of the target is unknown.
+        cleared: ?[]bool,
+    };
+
+    output: Output,
+
+    // The MiniLibX images used as buffers, presented in turn so one can be filled while the X server still
+    // reads the other. Only used with the `mlx` output.
+    canvases: [canvas_count]?*mlx.t_img,
+    /// Index in `canvases` of the canvas filled by the next `present`.
+    back_canvas: usize = 0,
 
     width: usize,
     height: usize,
 
     allocator: Allocator,
 
-    color_buffer: []Color,
+    /// Pixels of each of `canvases`, only written when tiles are resolved in `present`.
+    /// With the `memory` output, the first one is the framebuffer, allocated using `allocator`.
+    canvas_pixels: [canvas_count][]Color,
+    /// Streaming texture of the `sdl` output.
+    texture: ?*mlx.SDL_Texture,
+    /// Where the tiles are resolved during `present`.
+    resolve_target: ResolveTarget = undefined,
+    /// Tile-major, every tile owns a contiguous `tile_size * tile_size` block.
+    /// Allocated using `allocator`.
+    tile_color_buffer: []Color,
+    /// Same layout as `tile_color_buffer`.
     /// Allocated using `allocator`.
     depth_buffer: []f32,
+    /// Same layout as `tile_color_buffer`, index in `triangles` of the triangle visible at each pixel.
+    /// Only used with `visibility_buffer`.
+    /// Allocated using `allocator`.
+    id_buffer: []u32,
+    /// Hierarchical depth buffer, the nearest and farthest depth of every `hiz_block_size` block of
+    /// `depth_buffer`. Tile-major like `depth_buffer`, with blocks in row order inside a tile.
+    /// Allocated using `allocator`.
+    hiz_min: []f32,
+    hiz_max: []f32,
+    /// Farthest depth of every tile, top level of the hierarchy.
+    /// Allocated using `allocator`.
+    tile_depth_max: []f32,
+    /// Same layout as `tile_color_buffer`, fragments shaded at each pixel, saturating.
+    /// Only used by the `overdraw` render mode.
+    /// Allocated using `allocator`.
+    overdraw_buffer: []u8,
+    /// Nanoseconds spent in the last `rasterizeTile` of every tile, only measured by the `cost` render mode.
+    /// Allocated using `allocator`.
+    tile_cost: []u64,
+    /// Largest `tile_cost` of the current `draw`.
+    max_tile_cost: u64 = 1,
 
     clear_color: Color,
+    /// Color held by the tiles of the canvases flagged in `canvas_cleared`.
+    canvas_clear_color: Color,
+    /// Tiles not cleared yet since the last `clear`, they are cleared by their first `rasterizeTile`.
+    /// Allocated using `allocator`.
+    tile_pending_clear: []bool,
+    /// For each canvas then each tile, whether the area of the tile already holds `canvas_clear_color`.
+    /// Such tiles are skipped by `present` while nothing is drawn in them.
+    /// Allocated using `allocator`.
+    canvas_cleared: []bool,
+    /// Clear tiles when something is first drawn in them instead of clearing every tile in `clear`.
+    lazy_clear: bool = true,
+    /// Bounds of the triangles binned since the last `clear`.
+    frame_bounds: Rect = .empty,
+    /// `frame_bounds` of the previous `present`.
+    previous_bounds: Rect = .empty,
+    /// Send the whole canvas on the next `present`, instead of the area changed since the previous frame.
+    present_full: bool = true,
+    /// Tiles resolved by `present`, only a prefix is used when part of the screen is presented.
+    /// Allocated using `allocator`.
+    present_tiles: []u32,
 
     model: Matrix4,
     view: Matrix4,
@@ -178,33 +721,211 @@ pub const Graphics = struct {
     mvp: Matrix4,
 
     render_mode: Settings.RenderMode = .texture,
+    /// Rasterize only triangle IDs and depth, then shade each visible pixel once per `draw`.
+    visibility_buffer: bool = false,
+    /// Rasterize every tile twice, first depth only then shading the fragments left visible.
+    prepass: bool = false,
+    /// Bin triangles front to back instead of in submission order.
+    sort_triangles: bool = false,
+
+    tile_size: usize,
+    tiles_x: usize,
+    tiles_y: usize,
+    /// Indices of every tile, used to resolve the whole screen.
+    all_tiles: []u32,
+    /// Tiles with at least one triangle binned during the current `draw`.
+    active_tiles: std.ArrayListUnmanaged(u32) = .empty,
+    /// Every vertex of the vertex buffer of the current `draw`, transformed once.
+    vertex_cache: std.MultiArrayList(TransformedVertex) = .{},
+    /// Normal of every vertex of the vertex buffer of the current `draw`, transformed once.
+    normal_cache: std.ArrayListUnmanaged(Vector3) = .empty,
+    /// Triangles set up during the current `draw`.
+    triangles: std.ArrayListUnmanaged(Triangle) = .empty,
+    /// Order in which `triangles` are binned, front to back with `sort_triangles`.
+    triangle_order: std.ArrayListUnmanaged(u32) = .empty,
+    /// For each tile, indices into `triangles` in binning order.
+    bins: []std.ArrayListUnmanaged(u32),
+    /// For each tile, counters of its last `rasterizeTile`.
+    /// Allocated using `allocator`.
+    tile_stats: []Statistics,
+    /// Counters of every `draw` since the last `clear`.
+    stats: Statistics = .{},
+    /// Texture bound for the current `draw`.
+    draw_texture: ?Texture = null,
+
+    /// `null` when running on a single thread, tiles are then processed by the calling thread.
+    pool: ?*std.Thread.Pool,
+
+    pub const InitOptions = struct {
+        tile_size: usize = 64,
+        /// `0` uses every available core.
+        thread_count: usize = 0,
+    };
 
     pub fn init(
-        mlx_ptr: ?*anyopaque,
-        win_ptr: ?*anyopaque,
+        output: Output,
         w: usize,
         h: usize,
         allocator: Allocator,
+        options: InitOptions,
     ) !Graphics {
-        const img: ?*mlx.t_img = @ptrCast(@alignCast(mlx.mlx_new_image(mlx_ptr, @intCast(w), @intCast(h))));
+        var canvases = [_]?*mlx.t_img{null} ** canvas_count;
+        var canvas_pixels = [_][]Color{&.{}} ** canvas_count;
+        var texture: ?*mlx.SDL_Texture = null;
+
+        switch (output) {
+            .mlx => |window| {
+                for (&canvases, &canvas_pixels) |*canvas, *pixels| {
+                    const img: ?*mlx.t_img = @ptrCast(@alignCast(mlx.mlx_new_image(window.mlx_ptr, @intCast(w), @intCast(h))));
+                    canvas.* = img;
+                    pixels.* = @as([*]Color, @ptrCast(@alignCast(img.?.data)))[0..@as(usize, @intCast(w * h))];
+                }
+            },
+            .sdl => |renderer| {
+                // `Color` is laid out as a little-endian XRGB word, the transparency byte is ignored.
+                texture = mlx.SDL_CreateTexture(renderer, mlx.SDL_PIXELFORMAT_XRGB8888, mlx.SDL_TEXTUREACCESS_STREAMING, @intCast(w), @intCast(h)) orelse
+                    return error.UnableToCreateTexture;
+            },
+            .memory => canvas_pixels[0] = try allocator.alloc(Color, w * h),
+        }
+        errdefer if (texture) |t| mlx.SDL_DestroyTexture(t);
+        errdefer if (output == .memory) allocator.free(canvas_pixels[0]);
+
+        // Tiles are split in hierarchical depth blocks, whose rows are processed `lanes` pixels at a time.
+        const tile_size = std.mem.alignForward(usize, @max(options.tile_size, hiz_block_size), hiz_block_size);
+        const blocks_per_tile = (tile_size / hiz_block_size) * (tile_size / hiz_block_size);
+        const tiles_x = (w + tile_size - 1) / tile_size;
+        const tiles_y = (h + tile_size - 1) / tile_size;
+        const tile_count = tiles_x * tiles_y;
+
+        const tile_color_buffer = try allocator.alloc(Color, tile_count * tile_size * tile_size);
+        errdefer allocator.free(tile_color_buffer);
+        const depth_buffer = try allocator.alloc(f32, tile_count * tile_size * tile_size);
+        errdefer allocator.free(depth_buffer);
+        const id_buffer = try allocator.alloc(u32, tile_count * tile_size * tile_size);
+        errdefer allocator.free(id_buffer);
+        const hiz_min = try allocator.alloc(f32, tile_count * blocks_per_tile);
+        errdefer allocator.free(hiz_min);
+        const hiz_max = try allocator.alloc(f32, tile_count * blocks_per_tile);
+        errdefer allocator.free(hiz_max);
+        const tile_depth_max = try allocator.alloc(f32, tile_count);
+        errdefer allocator.free(tile_depth_max);
+        const overdraw_buffer = try allocator.alloc(u8, tile_count * tile_size * tile_size);
+        errdefer allocator.free(overdraw_buffer);
+        const tile_cost = try allocator.alloc(u64, tile_count);
+        errdefer allocator.free(tile_cost);
+        @memset(tile_cost, 0);
+
+        const all_tiles = try allocator.alloc(u32, tile_count);
+        errdefer allocator.free(all_tiles);
+        for (all_tiles, 0..) |*tile, index| tile.* = @intCast(index);
+        const present_tiles = try allocator.alloc(u32, tile_count);
+        errdefer allocator.free(present_tiles);
+
+        const bins = try allocator.alloc(std.ArrayListUnmanaged(u32), tile_count);
+        errdefer allocator.free(bins);
+        @memset(bins, .empty);
+
+        const tile_stats = try allocator.alloc(Statistics, tile_count);
+        errdefer allocator.free(tile_stats);
+
+        const tile_pending_clear = try allocator.alloc(bool, tile_count);
+        errdefer allocator.free(tile_pending_clear);
+        @memset(tile_pending_clear, true);
+        // The canvas starts with undefined pixels.
+        const canvas_cleared = try allocator.alloc(bool, canvas_count * tile_count);
+        errdefer allocator.free(canvas_cleared);
+        @memset(canvas_cleared, false);
+
+        const pool = try parallel.initPool(allocator, parallel.threadCount(options.thread_count));
 
         return Graphics{
-            .mlx_ptr = mlx_ptr,
-            .win_ptr = win_ptr,
-            .canvas = img,
+            .output = output,
+            .canvases = canvases,
             .width = w,
             .height = h,
-            .allocator = std.heap.page_allocator,
-            .color_buffer = @as([*]Color, @ptrCast(@alignCast(img.?.data)))[0..@as(usize, @intCast(w * h))],
-            .depth_buffer = try allocator.alloc(f32, @as(usize, @intCast(w * h))),
+            .allocator = allocator,
+            .canvas_pixels = canvas_pixels,
+            .texture = texture,
+            .tile_color_buffer = tile_color_buffer,
+            .depth_buffer = depth_buffer,
+            .id_buffer = id_buffer,
+            .hiz_min = hiz_min,
+            .hiz_max = hiz_max,
+            .tile_depth_max = tile_depth_max,
+            .overdraw_buffer = overdraw_buffer,
+            .tile_cost = tile_cost,
             .clear_color = Color.black,
+            .canvas_clear_color = Color.black,
+            .tile_pending_clear = tile_pending_clear,
+            .canvas_cleared = canvas_cleared,
             .model = Matrix4.identity(),
             .view = Matrix4.identity(),
             .projection = Matrix4.identity(),
             .mvp = Matrix4.identity(),
+            .tile_size = tile_size,
+            .tiles_x = tiles_x,
+            .tiles_y = tiles_y,
+            .all_tiles = all_tiles,
+            .present_tiles = present_tiles,
+            .bins = bins,
+            .tile_stats = tile_stats,
+            .pool = pool,
         };
     }
 
+    pub fn deinit(self: *Graphics) void {
+        parallel.deinitPool(self.allocator, self.pool);
+
+        self.allocator.free(self.canvas_cleared);
+        self.allocator.free(self.tile_pending_clear);
+        self.allocator.free(self.tile_stats);
+        for (self.bins) |*bin| bin.deinit(self.allocator);
+        self.allocator.free(self.bins);
+        self.triangle_order.deinit(self.allocator);
+        self.triangles.deinit(self.allocator);
+        self.normal_cache.deinit(self.allocator);
+        self.vertex_cache.deinit(self.allocator);
+        self.active_tiles.deinit(self.allocator);
+        self.allocator.free(self.present_tiles);
+        self.allocator.free(self.all_tiles);
+        self.allocator.free(self.tile_cost);
+        self.allocator.free(self.overdraw_buffer);
+        self.allocator.free(self.tile_depth_max);
+        self.allocator.free(self.hiz_max);
+        self.allocator.free(self.hiz_min);
+        self.allocator.free(self.id_buffer);
+        self.allocator.free(self.depth_buffer);
+        self.allocator.free(self.tile_color_buffer);
+        switch (self.output) {
+            .mlx => |window| for (self.canvases) |canvas| {
+                _ = mlx.mlx_destroy_image(window.mlx_ptr, canvas);
+            },
+            .sdl => mlx.SDL_DestroyTexture(self.texture),
+            .memory => self.allocator.free(self.canvas_pixels[0]),
+        }
+    }
+
+    /// Apply the rendering options and camera of `settings`.
+    pub fn configure(self: *Graphics, settings_: Settings) void {
+        self.render_mode = settings_.render_mode;
+        self.visibility_buffer = settings_.visibility_buffer;
+        self.prepass = settings_.render_prepass;
+        self.sort_triangles = settings_.sort_triangles;
+        self.lazy_clear = settings_.lazy_clear;
+
+        const view = Matrix4.translation(.{ .x = 0.0, .y = 0.0, .z = 0.0 });
+        const proj = Matrix4.projection(settings_.fov, settings_.window_width, settings_.window_height, 0.001, 1000.0);
+
+        self.loadViewMatrix(view);
+        self.loadProjectionMatrix(proj);
+    }
+
+    /// The framebuffer of the `memory` output, rows top-down, as of the last `present`.
+    pub fn framebuffer(self: *const Graphics) []const Color {
+        return self.canvas_pixels[0];
+    }
+
     pub fn resize(self: *Graphics, w: i32, h: i32) !void {
         _ = self;
         _ = w;
@@ -213,15 +934,240 @@ pub const Graphics = struct {
         // TODO: recreate canvas, reallocate depth_buffer, ...
     }
 
-    pub fn present(self: *const Graphics) void {
-        _ = mlx.mlx_put_image_to_window(self.mlx_ptr, self.win_ptr, self.canvas, 0, 0);
+    /// Resolve the tiles and send the frame to the output.
+    /// Only the area drawn in this frame or the previous one is resolved and sent, the rest of the window
+    /// already holds `clear_color`.
+    pub fn present(self: *Graphics) void {
+        const region = if (self.present_full)
+            Rect{ .min_x = 0, .min_y = 0, .max_x = self.width, .max_y = self.height }
+        else
+            self.frame_bounds.merge(self.previous_bounds);
+        self.previous_bounds = self.frame_bounds;
+        self.present_full = false;
+
+        switch (self.output) {
+            .mlx => |window| self.presentMlx(window.mlx_ptr, window.win_ptr, region),
+            .sdl => |renderer| self.presentSdl(renderer, region),
+            .memory => self.presentMemory(region),
+        }
+    }
+
+    /// Resolve the tiles into the framebuffer, which keeps the previous frame like a window does.
+    fn presentMemory(self: *Graphics, region: Rect) void {
+        if (region.isEmpty()) {
+            return;
+        }
+
+        self.resolve_target = .{
+            .pixels = self.canvas_pixels[0].ptr,
+            .stride = self.width,
+            .x = 0,
+            .y = 0,
+            .cleared = self.canvas_cleared[0..self.all_tiles.len],
+        };
+        self.dispatchTiles(self.regionTiles(region), resolveTile);
+    }
+
+    /// Resolve the tiles into the back canvas and queue it to the window without waiting for the X server.
+    fn presentMlx(self: *Graphics, mlx_ptr: ?*anyopaque, win_ptr: ?*anyopaque, region: Rect) void {
+        if (region.isEmpty()) {
+            return;
+        }
+
+        const canvas = self.canvases[self.back_canvas];
+
+        // The server may still be reading this canvas, presented `canvas_count` frames ago.
+        _ = mlx.mlx_image_wait(mlx_ptr, canvas);
+
+        const tile_count = self.all_tiles.len;
+        self.resolve_target = .{
+            .pixels = self.canvas_pixels[self.back_canvas].ptr,
+            .stride = self.width,
+            .x = 0,
+            .y = 0,
+            .cleared = self.canvas_cleared[self.back_canvas * tile_count ..][0..tile_count],
+        };
+        self.dispatchTiles(self.regionTiles(region), resolveTile);
+
+        // Canvas rows are top-down.
+        _ = mlx.mlx_put_image_region_to_window_async(
+            mlx_ptr,
+            win_ptr,
+            canvas,
+            0,
+            0,
+            @intCast(region.min_x),
+            @intCast(self.height - region.max_y),
+            @intCast(region.max_x - region.min_x),
+            @intCast(region.max_y - region.min_y),
+        );
+
+        self.back_canvas = (self.back_canvas + 1) % canvas_count;
+    }
+
+    /// Resolve the tiles straight into the locked streaming texture, then draw it and present.
+    /// The texture keeps the pixels outside of the locked area, the area is aligned on tiles since locked pixels
+    /// start undefined and `resolveTile` writes whole tiles.
+    fn presentSdl(self: *Graphics, renderer: *mlx.SDL_Renderer, region: Rect) void {
+        const ts = self.tile_size;
+
+        if (!region.isEmpty()) {
+            const min_x = region.min_x / ts * ts;
+            const min_y = region.min_y / ts * ts;
+            const max_x = @min(std.mem.alignForward(usize, region.max_x, ts), self.width);
+            const max_y = @min(std.mem.alignForward(usize, region.max_y, ts), self.height);
+
+            // Texture rows are top-down.
+            const rect = mlx.SDL_Rect{
+                .x = @intCast(min_x),
+                .y = @intCast(self.height - max_y),
+                .w = @intCast(max_x - min_x),
+                .h = @intCast(max_y - min_y),
+            };
+
+            var pixels: ?*anyopaque = null;
+            var pitch: c_int = 0;
+            if (mlx.SDL_LockTexture(self.texture, &rect, &pixels, &pitch)) {
+                self.resolve_target = .{
+                    .pixels = @ptrCast(@alignCast(pixels.?)),
+                    .stride = @as(usize, @intCast(pitch)) / @sizeOf(Color),
+                    .x = min_x,
+                    .y = self.height - max_y,
+                    .cleared = null,
+                };
+                self.dispatchTiles(self.regionTiles(region), resolveTile);
+                mlx.SDL_UnlockTexture(self.texture);
+            } else {
+                std.log.err("unable to lock the texture: {s}", .{std.mem.span(mlx.SDL_GetError())});
+            }
+        }
+
+        // The back buffer is undefined after presenting, the texture is drawn every frame.
+        _ = mlx.SDL_RenderTexture(renderer, self.texture, null, null);
+        _ = mlx.SDL_RenderPresent(renderer);
     }
 
+    /// Indices of the tiles overlapping `region`, in `present_tiles`.
+    fn regionTiles(self: *Graphics, region: Rect) []const u32 {
+        const ts = self.tile_size;
+        var tile_count: usize = 0;
+
+        for (region.min_y / ts..(region.max_y - 1) / ts + 1) |tile_y| {
+            for (region.min_x / ts..(region.max_x - 1) / ts + 1) |tile_x| {
+                self.present_tiles[tile_count] = @intCast(tile_x + tile_y * self.tiles_x);
+                tile_count += 1;
+            }
+        }
+
+        return self.present_tiles[0..tile_count];
+    }
+
+    /// The content of the window was lost, the next `present` sends the whole canvas.
+    pub fn invalidate(self: *Graphics) void {
+        self.present_full = true;
+    }
+
+    /// Something else was drawn over the window, the next `present` sends this area too.
+    /// Coordinates are in window space, with rows top-down.
+    pub fn invalidateArea(self: *Graphics, x: usize, y: usize, w: usize, h: usize) void {
+        const max_x = @min(x + w, self.width);
+        const max_y = @min(y + h, self.height);
+        if (x >= max_x or y >= max_y) {
+            return;
+        }
+
+        self.previous_bounds = self.previous_bounds.merge(.{
+            .min_x = x,
+            .min_y = self.height - max_y,
+            .max_x = max_x,
+            .max_y = self.height - y,
+        });
+    }
+
+    /// Start a new frame. With `lazy_clear` no pixel is written here, tiles are cleared by their first
+    /// `rasterizeTile` and tiles nothing is drawn in are filled by `present`, or not at all when the canvas
+    /// already holds `clear_color` there.
     pub fn clear(self: *Graphics) void {
-        for (0..@as(usize, @intCast(self.width * self.height))) |i| {
-            self.color_buffer[i] = self.clear_color;
-            // FIXME: I'm 100% sure this should be std.math.inf(f32) instead of 1.0
-            self.depth_buffer[i] = 1.0;
+        if (@as(u32, @bitCast(self.clear_color)) != @as(u32, @bitCast(self.canvas_clear_color))) {
+            @memset(self.canvas_cleared, false);
+            self.canvas_clear_color = self.clear_color;
+            self.present_full = true;
+        }
+        self.frame_bounds = .empty;
+
+        @memset(self.tile_pending_clear, true);
+        if (!self.lazy_clear) {
+            self.dispatchTiles(self.all_tiles, clearTile);
+        }
+        self.stats = .{};
+    }
+
+    /// Fill the blocks of a tile with `clear_color` and the farthest depth.
+    fn clearTile(self: *Graphics, tile_index: usize) void {
+        const ts = self.tile_size;
+        const blocks_per_tile = (ts / hiz_block_size) * (ts / hiz_block_size);
+
+        // `@memset` on the whole contiguous block lowers to wide vector stores.
+        @memset(self.tile_color_buffer[tile_index * ts * ts ..][0 .. ts * ts], self.clear_color);
+        // FIXME: I'm 100% sure this should be std.math.inf(f32) instead of 1.0
+        @memset(self.depth_buffer[tile_index * ts * ts ..][0 .. ts * ts], 1.0);
+        @memset(self.hiz_min[tile_index * blocks_per_tile ..][0..blocks_per_tile], 1.0);
+        @memset(self.hiz_max[tile_index * blocks_per_tile ..][0..blocks_per_tile], 1.0);
+        self.tile_depth_max[tile_index] = 1.0;
+        self.tile_pending_clear[tile_index] = false;
+    }
+
+    /// Runs `job` for every tile in `tiles`, spread over the worker pool when there is one.
+    /// Tiles never share pixels so jobs can write their own block without synchronization.
+    fn dispatchTiles(self: *Graphics, tiles: []const u32, comptime job: fn (*Graphics, usize) void) void {
+        const Dispatch = struct {
+            graphics: *Graphics,
+            tiles: []const u32,
+
+            fn run(dispatch: *const @This(), index: usize) void {
+                job(dispatch.graphics, dispatch.tiles[index]);
+            }
+        };
+
+        const dispatch = Dispatch{ .graphics = self, .tiles = tiles };
+        parallel.forEach(self.pool, &dispatch, tiles.len, Dispatch.run);
+    }
+
+    /// Copy the block of a tile into the rows of `resolve_target`, or fill them with `clear_color` when nothing
+    /// was drawn in the tile since the last `clear`.
+    fn resolveTile(self: *Graphics, tile_index: usize) void {
+        const ts = self.tile_size;
+        const tile_x0 = (tile_index % self.tiles_x) * ts;
+        const tile_y0 = (tile_index / self.tiles_x) * ts;
+        const tile_w = @min(ts, self.width - tile_x0);
+        const tile_h = @min(ts, self.height - tile_y0);
+        const block = self.tile_color_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+        const target = self.resolve_target;
+        const column = tile_x0 - target.x;
+
+        if (self.tile_pending_clear[tile_index]) {
+            if (target.cleared) |cleared| {
+                if (cleared[tile_index]) {
+                    return;
+                }
+                cleared[tile_index] = true;
+            }
+
+            for (0..tile_h) |ly| {
+                const row = self.height - (tile_y0 + ly) - 1 - target.y;
+                @memset(target.pixels[row * target.stride + column ..][0..tile_w], self.clear_color);
+            }
+            return;
+        }
+
+        if (target.cleared) |cleared| {
+            cleared[tile_index] = false;
+        }
+
+        for (0..tile_h) |ly| {
+            // Rows are stored bottom-up in the tiles.
+            const row = self.height - (tile_y0 + ly) - 1 - target.y;
+            @memcpy(target.pixels[row * target.stride + column ..][0..tile_w], block[ly * ts ..][0..tile_w]);
         }
     }
 
@@ -244,10 +1190,6 @@ pub const Graphics = struct {
         // self.recalculateMVP();
     }
 
-    inline fn edgeFn(a: Vector3, b: Vector3, c: Vector3) f32 {
-        return (a.x - c.x) * (b.y - c.y) - (a.y - c.y) * (b.x - c.x);
-    }
-
     // Two steps are necessary to correctly interpolate a value:
     // - Divide every values by their associated z vertex component.
     // - Compute the interpolate value.
@@ -261,14 +1203,6 @@ pub const Graphics = struct {
         v2.y /= z2;
     }
 
-    inline fn interpolateVector3(v0: Vector3, v1: Vector3, v2: Vector3, w: Vector3, z: f32) Vector3 {
-        return Vector3{
-            .x = (w.x * v0.x + w.y * v1.x + w.z * v2.x) * z,
-            .y = (w.x * v0.y + w.y * v1.y + w.z * v2.y) * z,
-            .z = (w.x * v0.z + w.y * v1.z + w.z * v2.z) * z,
-        };
-    }
-
     inline fn preInterpolateVector2(v0: *Vector2, v1: *Vector2, v2: *Vector2, z0: f32, z1: f32, z2: f32) void {
         v0.x /= z0;
         v0.y /= z0;
@@ -278,21 +1212,29 @@ pub const Graphics = struct {
         v2.y /= z2;
     }
 
-    inline fn interpolateVector2(v0: Vector2, v1: Vector2, v2: Vector2, w: Vector3, z: f32) Vector2 {
-        return Vector2{
-            .x = (w.x * v0.x + w.y * v1.x + w.z * v2.x) * z,
-            .y = (w.x * v0.y + w.y * v1.y + w.z * v2.y) * z,
-        };
-    }
-
     inline fn preInterpolateScalar(v0: *f32, v1: *f32, v2: *f32, z0: f32, z1: f32, z2: f32) void {
         v0.* /= z0;
         v1.* /= z1;
         v2.* /= z2;
     }
 
-    inline fn interpolateScalar(v0: Vector3, v1: Vector3, v2: Vector3, w: Vector3, z: f32) Vector3 {
-        return (w.x * v0.x + w.y * v1.x + w.z * v2.x) * z;
+    inline fn interpolateLanes(a0: f32, a1: f32, a2: f32, w0: FloatLanes, w1: FloatLanes, w2: FloatLanes, z: FloatLanes) FloatLanes {
+        return (w0 * @as(FloatLanes, @splat(a0)) + w1 * @as(FloatLanes, @splat(a1)) + w2 * @as(FloatLanes, @splat(a2))) * z;
+    }
+
+    /// Bool vectors do not support `and`.
+    inline fn maskAnd(a: MaskLanes, b: MaskLanes) MaskLanes {
+        return @select(bool, a, b, @as(MaskLanes, @splat(false)));
+    }
+
+    /// Add one fragment to the overdraw count of the lanes in `mask`.
+    inline fn countOverdraw(counts: *[lanes]u8, mask: MaskLanes) void {
+        const in: CountLanes = counts.*;
+        counts.* = in +| @select(u8, mask, @as(CountLanes, @splat(1)), @as(CountLanes, @splat(0)));
+    }
+
+    inline fn countLanes(mask: MaskLanes) u64 {
+        return @reduce(.Add, @select(u32, mask, @as(IdLanes, @splat(1)), @as(IdLanes, @splat(0))));
     }
 
     pub const DrawOptions = struct {
@@ -302,10 +1244,17 @@ pub const Graphics = struct {
         offset: Vector3 = .{},
     };
 
-    pub fn draw(self: *const Graphics, mesh: *const Mesh, options: DrawOptions) void {
+    /// Set up and bin every face of `mesh`, then rasterize the touched tiles in parallel.
+    pub fn draw(self: *Graphics, mesh: *const Mesh, options: DrawOptions) !void {
         const width: f32 = @floatFromInt(self.width);
         const height: f32 = @floatFromInt(self.height);
 
+        self.triangles.clearRetainingCapacity();
+        for (self.active_tiles.items) |tile_index| {
+            self.bins[tile_index].clearRetainingCapacity();
+        }
+        self.active_tiles.clearRetainingCapacity();
+
         // const off = Vector3{
         //     .y = options.offset.y,
         //     .z = options.offset.z,
@@ -314,140 +1263,788 @@ pub const Graphics = struct {
         const model = Matrix4.model(options.position, options.rotation);
         const mvp = self.projection.mul(self.view).mul(model);
 
-        for (mesh.faces.items, 0..mesh.faces.items.len) |face, face_index| {
-            var v0 = mesh.vertices.items[face.vertices[0]];
-            var v1 = mesh.vertices.items[face.vertices[1]];
-            var v2 = mesh.vertices.items[face.vertices[2]];
+        // Guard band planes in normalized device coordinates.
+        const guard = Vector2{
+            .x = 1.0 + 2.0 * guard_band / width,
+            .y = 1.0 + 2.0 * guard_band / height,
+        };
+
+        const vertex_zone = profile.begin("vertex");
+        try self.processVertices(mesh, mvp, guard);
+        vertex_zone.end();
+
+        const setup_zone = profile.begin("setup");
+
+        const transformed = self.vertex_cache.slice();
+        const clip_x = transformed.items(.x);
+        const clip_y = transformed.items(.y);
+        const clip_z = transformed.items(.z);
+        const clip_w = transformed.items(.w);
+        const ndc_x = transformed.items(.ndc_x);
+        const ndc_y = transformed.items(.ndc_y);
+        const flags = transformed.items(.flags);
+
+        const face_count = mesh.indexBuffer.len / 3;
+        self.stats.faces_submitted += face_count;
+
+        for (0..face_count) |face_index| {
+            const face = mesh.indexBuffer[face_index * 3 ..][0..3];
+            const f0 = flags[face[0]];
+            const f1 = flags[face[1]];
+            const f2 = flags[face[2]];
+
+            // Every vertex is outside of the same plane.
+            if ((f0 & f1 & f2) != 0) {
+                if ((f0 & f1 & f2 & planeBit(.near)) != 0) {
+                    self.stats.near_rejected += 1;
+                } else {
+                    self.stats.offscreen_rejected += 1;
+                }
+                continue;
+            }
+
+            const inside = (f0 | f1 | f2) == 0;
+
+            // Triangles needing no clipping are culled before gathering their attributes.
+            if (inside and !isFrontFacing(
+                .{ .x = ndc_x[face[0]], .y = ndc_y[face[0]] },
+                .{ .x = ndc_x[face[1]], .y = ndc_y[face[1]] },
+                .{ .x = ndc_x[face[2]], .y = ndc_y[face[2]] },
+            )) {
+                self.stats.backface_culled += 1;
+                continue;
+            }
 
             // TODO: compute normals if not present.
-            // TODO: compute texture coords if not present.
 
-            v0 = mvp.mul(v0);
-            v1 = mvp.mul(v1);
-            v2 = mvp.mul(v2);
+            var corners: [3]ClipVertex = undefined;
+            inline for (0..3) |i| {
+                const vertex = face[i];
 
-            const edge1 = v1.sub(v0).normalized();
-            const edge2 = v2.sub(v1).normalized();
-            const face_normal = edge1.cross(edge2);
+                corners[i] = .{
+                    .position = .{ .x = clip_x[vertex], .y = clip_y[vertex], .z = clip_z[vertex], .w = clip_w[vertex] },
+                    .ndc = .{ .x = ndc_x[vertex], .y = ndc_y[vertex] },
+                    .uv = mesh.vertexBuffer[vertex].uv,
+                    .normal = self.normal_cache.items[vertex],
+                };
+            }
 
-            // Only draw front faces.
-            if (face_normal.dot(Vector3{ .z = 1 }) < 0.0) {
+            if (inside) {
+                self.countSetup(try self.setupTriangle(corners[0], corners[1], corners[2], face_index));
                 continue;
             }
 
-            var n0 = mesh.normals.items[face.normals[0]];
-            var n1 = mesh.normals.items[face.normals[1]];
-            var n2 = mesh.normals.items[face.normals[2]];
+            var polygon: [max_clip_vertices]ClipVertex = undefined;
+            var emptied_by: ClipPlane = undefined;
+            const count = clipTriangle(corners, f0 | f1 | f2, guard, &polygon, &emptied_by);
 
-            var t0: Vector2 = undefined;
-            var t1: Vector2 = undefined;
-            var t2: Vector2 = undefined;
-
-            if (mesh.textureCoords.items.len > 1) {
-                t0 = mesh.textureCoords.items[face.textures[0]];
-                t1 = mesh.textureCoords.items[face.textures[1]];
-                t2 = mesh.textureCoords.items[face.textures[2]];
-            } else {
-                const pv0 = mesh.vertices.items[face.vertices[0]];
-                const pv1 = mesh.vertices.items[face.vertices[1]];
-                const pv2 = mesh.vertices.items[face.vertices[2]];
-
-                if (face_normal.dot(Vector3.z_axis) >= 0.0 or face_normal.dot(Vector3.inv_z_axis) >= 0.0) {
-                    t0 = pv0.yz();
-                    t1 = pv1.yz();
-                    t2 = pv2.yz();
+            if (count < 3) {
+                if (emptied_by == .near) {
+                    self.stats.near_rejected += 1;
                 } else {
-                    t0 = pv0.xy();
-                    t1 = pv1.xy();
-                    t2 = pv2.xy();
+                    self.stats.offscreen_rejected += 1;
                 }
+                continue;
             }
 
-            n0 = self.model.mul(n0);
-            n1 = self.model.mul(n1);
-            n2 = self.model.mul(n2);
+            self.stats.clipped_triangles += count - 2;
+
+            // The face is set up when any of its triangles is, otherwise it counts as culled when any of
+            // them is back facing or degenerate.
+            var outcome: Setup = .offscreen;
+            for (1..count - 1) |i| {
+                const setup: Setup = if (isFrontFacing(polygon[0].ndc, polygon[i].ndc, polygon[i + 1].ndc))
+                    try self.setupTriangle(polygon[0], polygon[i], polygon[i + 1], face_index)
+                else
+                    .degenerate;
+                outcome = @enumFromInt(@max(@intFromEnum(outcome), @intFromEnum(setup)));
+            }
+            self.countSetup(outcome);
+        }
 
-            // FIXME:
-            // This fix the depth buffer bug. There is still a performance hit when the camera enters a mesh.
-            if (v0.z < 0.1 or v1.z < 0.1 or v2.z < 0.1) {
-                continue;
+        setup_zone.end();
+
+        const bin_zone = profile.begin("bin");
+        try self.binTriangles();
+        bin_zone.end();
+
+        self.draw_texture = options.texture;
+        const raster_zone = profile.begin("raster");
+        self.dispatchTiles(self.active_tiles.items, rasterizeTile);
+        raster_zone.end();
+
+        for (self.active_tiles.items) |tile_index| {
+            self.stats.add(self.tile_stats[tile_index]);
+        }
+
+        if (self.render_mode == .cost) {
+            self.max_tile_cost = 1;
+            for (self.active_tiles.items) |tile_index| {
+                self.max_tile_cost = @max(self.max_tile_cost, self.tile_cost[tile_index]);
+
+                // The whole tile is tinted, not only the triangles.
+                const tile_x = (tile_index % self.tiles_x) * self.tile_size;
+                const tile_y = (tile_index / self.tiles_x) * self.tile_size;
+                self.frame_bounds = self.frame_bounds.merge(.{
+                    .min_x = tile_x,
+                    .min_y = tile_y,
+                    .max_x = @min(tile_x + self.tile_size, self.width),
+                    .max_y = @min(tile_y + self.tile_size, self.height),
+                });
             }
+            self.dispatchTiles(self.active_tiles.items, tintTileCost);
+        }
+    }
+
+    /// What became of a triangle in `setupTriangle`, from the least to the most progress made.
+    const Setup = enum { offscreen, degenerate, set_up };
+
+    /// Count the outcome of a face.
+    fn countSetup(self: *Graphics, setup: Setup) void {
+        switch (setup) {
+            .offscreen => self.stats.offscreen_rejected += 1,
+            .degenerate => self.stats.backface_culled += 1,
+            .set_up => self.stats.faces_set_up += 1,
+        }
+    }
+
+    /// Triangle setup: convert a front facing, clipped triangle to raster space and compute its fixed-point
+    /// edge functions.
+    fn setupTriangle(self: *Graphics, a: ClipVertex, b: ClipVertex, c: ClipVertex, face_index: usize) !Setup {
+        const width: f32 = @floatFromInt(self.width);
+        const height: f32 = @floatFromInt(self.height);
 
-            // Convert from screen space to NDC then raster (in one go)
-            v0.x = (1 + v0.x) * 0.5 * width;
-            v0.y = (1 + v0.y) * 0.5 * height;
+        var v0 = Vector3{ .x = a.ndc.x, .y = a.ndc.y, .z = a.position.z };
+        var v1 = Vector3{ .x = b.ndc.x, .y = b.ndc.y, .z = b.position.z };
+        var v2 = Vector3{ .x = c.ndc.x, .y = c.ndc.y, .z = c.position.z };
 
-            v1.x = (1 + v1.x) * 0.5 * width;
-            v1.y = (1 + v1.y) * 0.5 * height;
+        var t0 = a.uv;
+        var t1 = b.uv;
+        var t2 = c.uv;
+        var n0 = a.normal;
+        var n1 = b.normal;
+        var n2 = c.normal;
 
-            v2.x = (1 + v2.x) * 0.5 * width;
-            v2.y = (1 + v2.y) * 0.5 * height;
+        // Convert from NDC to raster (in one go)
+        v0.x = (1 + v0.x) * 0.5 * width;
+        v0.y = (1 + v0.y) * 0.5 * height;
 
-            var min_x: isize = @intFromFloat(@min(v0.x, v1.x, v2.x));
-            var max_x: isize = @intFromFloat(@max(v0.x, v1.x, v2.x));
-            var min_y: isize = @intFromFloat(@min(v0.y, v1.y, v2.y));
-            var max_y: isize = @intFromFloat(@max(v0.y, v1.y, v2.y));
+        v1.x = (1 + v1.x) * 0.5 * width;
+        v1.y = (1 + v1.y) * 0.5 * height;
 
-            // The triangle is outside of the screen.
-            if (min_x >= self.width or min_y >= self.height or max_x < 0 or max_y < 0) {
-                continue;
+        v2.x = (1 + v2.x) * 0.5 * width;
+        v2.y = (1 + v2.y) * 0.5 * height;
+
+        var min_x: isize = @intFromFloat(@min(v0.x, v1.x, v2.x));
+        var max_x: isize = @intFromFloat(@max(v0.x, v1.x, v2.x));
+        var min_y: isize = @intFromFloat(@min(v0.y, v1.y, v2.y));
+        var max_y: isize = @intFromFloat(@max(v0.y, v1.y, v2.y));
+
+        // The triangle is outside of the screen.
+        if (min_x >= self.width or min_y >= self.height or max_x < 0 or max_y < 0) {
+            return .offscreen;
+        }
+
+        // Triangles in the guard band only pay for their visible area.
+        min_x = @max(min_x, 0);
+        min_y = @max(min_y, 0);
+        max_x = @min(max_x, @as(isize, @intCast(self.width)) - 1);
+        max_y = @min(max_y, @as(isize, @intCast(self.height)) - 1);
+
+        preInterpolateVector2(&t0, &t1, &t2, v0.z, v1.z, v2.z);
+        preInterpolateVector3(&n0, &n1, &n2, v0.z, v1.z, v2.z);
+
+        // inverse the z-axis
+        v0.z = 1.0 / v0.z;
+        v1.z = 1.0 / v1.z;
+        v2.z = 1.0 / v2.z;
+
+        const x0 = snap(v0.x);
+        const y0 = snap(v0.y);
+        const x1 = snap(v1.x);
+        const y1 = snap(v1.y);
+        const x2 = snap(v2.x);
+        const y2 = snap(v2.y);
+
+        const area = (x0 - x2) * (y1 - y2) - (y0 - y2) * (x1 - x2);
+
+        // Degenerate once snapped to the sub-pixel grid.
+        if (area <= 0) {
+            return .degenerate;
+        }
+
+        // Center of the first pixel of the bounding box, in sub-pixels.
+        const half_pixel: i64 = 1 << (sub_pixel_bits - 1);
+        const origin_x = (@as(i64, @intCast(min_x)) << sub_pixel_bits) + half_pixel;
+        const origin_y = (@as(i64, @intCast(min_y)) << sub_pixel_bits) + half_pixel;
+
+        try self.triangles.append(self.allocator, .{
+            .v0 = v0,
+            .v1 = v1,
+            .v2 = v2,
+            .t0 = t0,
+            .t1 = t1,
+            .t2 = t2,
+            .n0 = n0,
+            .n1 = n1,
+            .n2 = n2,
+            .edges = .{
+                Edge.init(x1, y1, x2, y2, origin_x, origin_y),
+                Edge.init(x2, y2, x0, y0, origin_x, origin_y),
+                Edge.init(x0, y0, x1, y1, origin_x, origin_y),
+            },
+            .inv_area = 1.0 / @as(f32, @floatFromInt(area)),
+            // Depth is affine in raster space, so its extremes are at the vertices.
+            .depth_min = 1.0 - @max(v0.z, v1.z, v2.z),
+            .depth_max = 1.0 - @min(v0.z, v1.z, v2.z),
+            .min_x = @intCast(min_x),
+            .min_y = @intCast(min_y),
+            .max_x = @intCast(max_x + 1),
+            .max_y = @intCast(max_y + 1),
+            .face_index = face_index,
+        });
+        return .set_up;
+    }
+
+    /// Bin every triangle of the current `draw` into the tiles its bounding box overlaps, front to back
+    /// with `sort_triangles` so occluded fragments fail the depth test instead of being shaded then overwritten.
+    fn binTriangles(self: *Graphics) !void {
+        const triangles = self.triangles.items;
+        try self.triangle_order.resize(self.allocator, triangles.len);
+        const order = self.triangle_order.items;
+
+        if (self.sort_triangles and triangles.len > 1) {
+            // Counting sort on the nearest depth of each triangle, quantized in `bucket_count` buckets.
+            // Exact ordering is not needed, only most occluders being drawn before what they hide.
+            const bucket_count = 1024;
+
+            var nearest: f32 = std.math.inf(f32);
+            var farthest: f32 = -std.math.inf(f32);
+            for (triangles) |tri| {
+                nearest = @min(nearest, tri.depth_min);
+                farthest = @max(farthest, tri.depth_min);
             }
 
-            min_x = @max(min_x, 0);
-            min_y = @max(min_y, 0);
-            max_x = @min(max_x, @as(isize, @intCast(self.width)) - 1);
-            max_y = @min(max_y, @as(isize, @intCast(self.height)) - 1);
+            const scale: f32 = if (farthest > nearest) @as(f32, bucket_count - 1) / (farthest - nearest) else 0.0;
+            var offsets = [_]u32{0} ** (bucket_count + 1);
 
-            preInterpolateVector2(&t0, &t1, &t2, v0.z, v1.z, v2.z);
-            preInterpolateVector3(&n0, &n1, &n2, v0.z, v1.z, v2.z);
+            for (triangles) |tri| {
+                const bucket: usize = @min(@as(usize, @intFromFloat((tri.depth_min - nearest) * scale)), bucket_count - 1);
+                offsets[bucket + 1] += 1;
+            }
+            for (1..bucket_count + 1) |i| {
+                offsets[i] += offsets[i - 1];
+            }
+            for (triangles, 0..) |tri, triangle_index| {
+                const bucket: usize = @min(@as(usize, @intFromFloat((tri.depth_min - nearest) * scale)), bucket_count - 1);
+                order[offsets[bucket]] = @intCast(triangle_index);
+                offsets[bucket] += 1;
+            }
+        } else {
+            for (order, 0..) |*triangle_index, index| triangle_index.* = @intCast(index);
+        }
+
+        for (order) |triangle_index| {
+            const tri = &triangles[triangle_index];
+            self.frame_bounds = self.frame_bounds.merge(.{ .min_x = tri.min_x, .min_y = tri.min_y, .max_x = tri.max_x, .max_y = tri.max_y });
 
-            // inverse the z-axis
-            v0.z = 1.0 / v0.z;
-            v1.z = 1.0 / v1.z;
-            v2.z = 1.0 / v2.z;
+            for (tri.min_y / self.tile_size..(tri.max_y - 1) / self.tile_size + 1) |tile_y| {
+                for (tri.min_x / self.tile_size..(tri.max_x - 1) / self.tile_size + 1) |tile_x| {
+                    const tile_index = tile_x + tile_y * self.tiles_x;
+                    const bin = &self.bins[tile_index];
 
-            const area = edgeFn(v0, v1, v2);
+                    if (bin.items.len == 0) {
+                        try self.active_tiles.append(self.allocator, @intCast(tile_index));
+                    }
+                    try bin.append(self.allocator, triangle_index);
+                }
+            }
+        }
+    }
 
-            for (@intCast(min_y)..@intCast(max_y + 1)) |y| {
-                for (@intCast(min_x)..@intCast(max_x + 1)) |x| {
-                    const p = Vector3{
-                        .x = @as(f32, @floatFromInt(x)) + 0.5,
-                        .y = @as(f32, @floatFromInt(y)) + 0.5,
-                        .z = 0.0,
-                    };
-                    var w0 = edgeFn(v1, v2, p);
-                    var w1 = edgeFn(v2, v0, p);
-                    var w2 = edgeFn(v0, v1, p);
+    /// Vertex stage: transform every vertex of the vertex buffer of `mesh` exactly once, `lanes` at a time.
+    /// Also flags the clipping planes each vertex is outside of, `guard` being the guard band in NDC.
+    fn processVertices(self: *Graphics, mesh: *const Mesh, mvp: Matrix4, guard: Vector2) !void {
+        const vertices = mesh.vertexBuffer;
+        try self.vertex_cache.resize(self.allocator, vertices.len);
+
+        const transformed = self.vertex_cache.slice();
+        const xs = transformed.items(.x);
+        const ys = transformed.items(.y);
+        const zs = transformed.items(.z);
+        const ws = transformed.items(.w);
+        const ndc_x = transformed.items(.ndc_x);
+        const ndc_y = transformed.items(.ndc_y);
+        const flags = transformed.items(.flags);
+
+        const guard_x: FloatLanes = @splat(guard.x);
+        const guard_y: FloatLanes = @splat(guard.y);
+
+        var i: usize = 0;
+        while (i < vertices.len) : (i += lanes) {
+            const count = @min(lanes, vertices.len - i);
+
+            // The last batch repeats its final vertex in the unused lanes.
+            var px: FloatLanes = undefined;
+            var py: FloatLanes = undefined;
+            var pz: FloatLanes = undefined;
+            inline for (0..lanes) |l| {
+                const v = vertices[i + @min(l, count - 1)].position;
+                px[l] = v.x;
+                py[l] = v.y;
+                pz[l] = v.z;
+            }
 
-                    if (w0 < 0.0 or w1 < 0.0 or w2 < 0.0) {
-                        continue;
+            const clip = mvp.mulLanes(lanes, px, py, pz);
+            const clip_ndc_x = clip[0] / clip[3];
+            const clip_ndc_y = clip[1] / clip[3];
+
+            var clip_flags: FlagLanes = @splat(0);
+            clip_flags |= planeFlag(.near, clip[2] < @as(FloatLanes, @splat(near_plane)));
+            clip_flags |= planeFlag(.left, clip[0] < -guard_x * clip[3]);
+            clip_flags |= planeFlag(.right, clip[0] > guard_x * clip[3]);
+            clip_flags |= planeFlag(.bottom, clip[1] < -guard_y * clip[3]);
+            clip_flags |= planeFlag(.top, clip[1] > guard_y * clip[3]);
+
+            if (count == lanes) {
+                xs[i..][0..lanes].* = clip[0];
+                ys[i..][0..lanes].* = clip[1];
+                zs[i..][0..lanes].* = clip[2];
+                ws[i..][0..lanes].* = clip[3];
+                ndc_x[i..][0..lanes].* = clip_ndc_x;
+                ndc_y[i..][0..lanes].* = clip_ndc_y;
+                flags[i..][0..lanes].* = clip_flags;
+            } else {
+                inline for (0..lanes) |l| {
+                    if (l < count) {
+                        xs[i + l] = clip[0][l];
+                        ys[i + l] = clip[1][l];
+                        zs[i + l] = clip[2][l];
+                        ws[i + l] = clip[3][l];
+                        ndc_x[i + l] = clip_ndc_x[l];
+                        ndc_y[i + l] = clip_ndc_y[l];
+                        flags[i + l] = clip_flags[l];
                     }
+                }
+            }
+        }
+
+        try self.normal_cache.resize(self.allocator, vertices.len);
+        for (self.normal_cache.items, vertices) |*out, vertex| {
+            out.* = self.model.mul(vertex.normal);
+        }
+    }
+
+    /// Rasterize every triangle binned into a tile, in binning order, inside the tile's own block.
+    /// With `prepass` the bin is walked twice, so only the fragments left visible by the depth-only pass get shaded.
+    fn rasterizeTile(self: *Graphics, tile_index: usize) void {
+        const ts = self.tile_size;
+        const stats = &self.tile_stats[tile_index];
+        stats.* = .{};
+
+        const started = if (self.render_mode == .cost) std.time.Instant.now() catch null else null;
+
+        if (self.tile_pending_clear[tile_index]) {
+            self.clearTile(tile_index);
+        }
+
+        if (self.visibility_buffer) {
+            @memset(self.id_buffer[tile_index * ts * ts ..][0 .. ts * ts], no_triangle);
+        }
+
+        if (self.render_mode == .overdraw) {
+            @memset(self.overdraw_buffer[tile_index * ts * ts ..][0 .. ts * ts], 0);
+        }
+
+        if (self.prepass) {
+            const depth_zone = profile.begin("tile depth");
+            self.rasterizeBin(tile_index, .depth, stats);
+            depth_zone.end();
+
+            const shade_zone = profile.begin("tile shade");
+            self.rasterizeBin(tile_index, .shade, stats);
+            shade_zone.end();
+        } else {
+            const full_zone = profile.begin("tile raster");
+            self.rasterizeBin(tile_index, .full, stats);
+            full_zone.end();
+        }
+
+        if (self.visibility_buffer) {
+            const shade_zone = profile.begin("tile shade");
+            self.shadeVisibleTile(tile_index, stats);
+            shade_zone.end();
+        }
+
+        if (self.render_mode == .overdraw) {
+            self.resolveOverdraw(tile_index);
+        }
+
+        if (started) |start| {
+            const end = std.time.Instant.now() catch start;
+            self.tile_cost[tile_index] = end.since(start);
+        }
+    }
+
+    /// Replace every pixel of the tile something was counted at with the color of its overdraw count.
+    fn resolveOverdraw(self: *Graphics, tile_index: usize) void {
+        const ts = self.tile_size;
+        const counts = self.overdraw_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+        const color_block = self.tile_color_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+
+        for (counts, color_block) |count, *color| {
+            if (count != 0) {
+                color.* = overdraw_colors[@min(count, overdraw_colors.len) - 1];
+            }
+        }
+    }
+
+    /// Blend a tile with the color of its raster time, relative to the slowest tile of the `draw`.
+    fn tintTileCost(self: *Graphics, tile_index: usize) void {
+        const ts = self.tile_size;
+        const cost = @as(f32, @floatFromInt(self.tile_cost[tile_index])) / @as(f32, @floatFromInt(self.max_tile_cost));
+        const tint: u32 = @bitCast(heatColor(cost));
+        const color_words: []u32 = @ptrCast(self.tile_color_buffer[tile_index * ts * ts ..][0 .. ts * ts]);
+
+        // Average of both colors, channel by channel.
+        for (color_words) |*color| {
+            color.* = ((color.* >> 1) & 0x7f7f7f7f) + ((tint >> 1) & 0x7f7f7f7f);
+        }
+    }
 
-                    w0 /= area;
-                    w1 /= area;
-                    w2 /= area;
+    /// Colors of 1 up to `overdraw_colors.len` or more fragments counted at a pixel.
+    const overdraw_colors = blk: {
+        var palette: [8]Color = undefined;
+        for (&palette, 0..) |*color, i| {
+            color.* = heatColor(@as(f32, @floatFromInt(i)) / (palette.len - 1));
+        }
+        break :blk palette;
+    };
 
-                    const z = w0 * v0.z + w1 * v1.z + w2 * v2.z;
-                    const inv_z = 1.0 / z;
-                    const w = Vector3{ .x = w0, .y = w1, .z = w2 };
+    /// Blue for 0, through cyan, green and yellow, to red for 1.
+    fn heatColor(t: f32) Color {
+        const stops = [_][3]f32{
+            .{ 0.0, 0.0, 1.0 },
+            .{ 0.0, 1.0, 1.0 },
+            .{ 0.0, 1.0, 0.0 },
+            .{ 1.0, 1.0, 0.0 },
+            .{ 1.0, 0.0, 0.0 },
+        };
 
-                    const uv = interpolateVector2(t0, t1, t2, w, inv_z);
-                    const n = interpolateVector3(n0, n1, n2, w, inv_z);
+        const x = std.math.clamp(t, 0.0, 1.0) * (stops.len - 1);
+        const i: usize = @min(@as(usize, @intFromFloat(x)), stops.len - 2);
+        const f = x - @as(f32, @floatFromInt(i));
 
-                    const index: usize = x + (self.height - y - 1) * self.width;
-                    const rev_z = 1.0 - z;
+        var channels: [3]u8 = undefined;
+        for (&channels, stops[i], stops[i + 1]) |*channel, a, b| {
+            channel.* = @intFromFloat((a + (b - a) * f) * 255.0);
+        }
+        return .{ .r = channels[0], .g = channels[1], .b = channels[2], .t = 0 };
+    }
 
-                    if (rev_z > self.depth_buffer[index]) {
+    /// One pass over the bin of a tile.
+    /// Triangles are walked one hierarchical depth block at a time so hidden blocks, or triangles hidden in the
+    /// whole tile, are rejected before any per-pixel work.
+    fn rasterizeBin(self: *Graphics, tile_index: usize, comptime pass_kind: RasterPass, stats: *Statistics) void {
+        const ts = self.tile_size;
+        const bs = hiz_block_size;
+        const blocks_per_row = ts / bs;
+        const tile_x0 = (tile_index % self.tiles_x) * ts;
+        const tile_y0 = (tile_index / self.tiles_x) * ts;
+        const tile_x1 = @min(tile_x0 + ts, self.width);
+        const tile_y1 = @min(tile_y0 + ts, self.height);
+        const color_block = self.tile_color_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+        const depth_block = self.depth_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+        const hiz_min = self.hiz_min[tile_index * blocks_per_row * blocks_per_row ..][0 .. blocks_per_row * blocks_per_row];
+        const hiz_max = self.hiz_max[tile_index * blocks_per_row * blocks_per_row ..][0 .. blocks_per_row * blocks_per_row];
+
+        const id_block = self.id_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+        const overdraw_block = self.overdraw_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+
+        const color_words: []u32 = @ptrCast(color_block);
+        const lane_offsets = std.simd.iota(usize, lanes);
+        const lane_steps = std.simd.iota(i64, lanes);
+
+        // With the pre-pass or the visibility buffer every pixel is shaded at most once, so the overdraw view
+        // counts the depth test passes of the pass deciding visibility instead, where the triangle order and
+        // the hierarchical depth make a difference.
+        const count_depth_passes = self.render_mode == .overdraw and pass_kind != .shade and
+            (self.prepass or self.visibility_buffer);
+
+        for (self.bins[tile_index].items) |triangle_index| {
+            const tri = &self.triangles.items[triangle_index];
+
+            const min_x = @max(tri.min_x, tile_x0);
+            const min_y = @max(tri.min_y, tile_y0);
+            const max_x = @min(tri.max_x, tile_x1);
+            const max_y = @min(tri.max_y, tile_y1);
+
+            if (min_x >= max_x or min_y >= max_y) {
+                continue;
+            }
+
+            // The whole triangle is behind everything already drawn in this tile.
+            if (tri.depth_min > self.tile_depth_max[tile_index]) {
+                continue;
+            }
+
+            var tile_changed = false;
+
+            for ((min_y - tile_y0) / bs..(max_y - 1 - tile_y0) / bs + 1) |block_y| {
+                for ((min_x - tile_x0) / bs..(max_x - 1 - tile_x0) / bs + 1) |block_x| {
+                    const hiz_index = block_x + block_y * blocks_per_row;
+
+                    // Every pixel of the block is nearer than the triangle.
+                    if (tri.depth_min > hiz_max[hiz_index]) {
                         continue;
                     }
 
-                    self.color_buffer[index] = fragmentShader(self.render_mode, uv, n, options.texture, face_index);
-                    self.depth_buffer[index] = rev_z;
+                    // Every pixel of the block is farther than the triangle, the depth test cannot fail.
+                    const always_pass = tri.depth_max <= hiz_min[hiz_index];
+
+                    const block_x0 = tile_x0 + block_x * bs;
+                    const block_y0 = tile_y0 + block_y * bs;
+                    const row_y0 = @max(min_y, block_y0);
+                    const row_y1 = @min(max_y, block_y0 + bs);
+                    const span_x1 = @min(max_x, block_x0 + bs);
+
+                    // Move the edge functions from the bounding box origin to the first span of the block.
+                    const offset_x = @as(i64, @intCast(block_x0)) - @as(i64, @intCast(tri.min_x));
+                    const offset_y = @as(i64, @intCast(row_y0)) - @as(i64, @intCast(tri.min_y));
+
+                    var row_edges: [3]EdgeLanes = undefined;
+                    var span_steps: [3]EdgeLanes = undefined;
+                    inline for (0..3) |i| {
+                        const edge = tri.edges[i];
+                        row_edges[i] = @as(EdgeLanes, @splat(edge.origin + edge.step_x * offset_x + edge.step_y * offset_y)) +
+                            lane_steps * @as(EdgeLanes, @splat(edge.step_x));
+                        span_steps[i] = @splat(edge.step_x * lanes);
+                    }
+
+                    var block_written = false;
+
+                    for (row_y0..row_y1) |y| {
+                        const row = (y - tile_y0) * ts;
+                        var edges = row_edges;
+
+                        var x = block_x0;
+                        while (x < span_x1) : ({
+                            x += lanes;
+                            inline for (0..3) |i| edges[i] += span_steps[i];
+                        }) {
+                            const xs = @as(IndexLanes, @splat(x)) + lane_offsets;
+
+                            const in_box = maskAnd(xs >= @as(IndexLanes, @splat(min_x)), xs < @as(IndexLanes, @splat(max_x)));
+                            var covered = in_box;
+                            inline for (0..3) |i| {
+                                covered = maskAnd(covered, edges[i] >= @as(EdgeLanes, @splat(0)));
+                            }
+
+                            if (pass_kind != .shade) {
+                                stats.bbox_pixels_tested += countLanes(in_box);
+                            }
+
+                            if (!@reduce(.Or, covered)) {
+                                continue;
+                            }
+
+                            const weights = barycentrics(tri, edges, covered);
+                            const z = interpolatedDepth(tri, weights);
+                            const rev_z = @as(FloatLanes, @splat(1.0)) - z;
+
+                            const index = row + (x - tile_x0);
+                            const depth: FloatLanes = depth_block[index..][0..lanes].*;
+                            const pass = if (always_pass) covered else maskAnd(covered, rev_z <= depth);
+
+                            if (pass_kind != .shade) {
+                                const covered_count = countLanes(covered);
+                                const pass_count = countLanes(pass);
+                                stats.pixels_covered += covered_count;
+                                stats.depth_passes += pass_count;
+                                stats.depth_fails += covered_count - pass_count;
+                            }
+
+                            if (!@reduce(.Or, pass)) {
+                                continue;
+                            }
+
+                            if (count_depth_passes) {
+                                countOverdraw(overdraw_block[index..][0..lanes], pass);
+                            }
+
+                            if (pass_kind == .depth) {
+                                // Shading waits for the second pass.
+                            } else if (self.visibility_buffer) {
+                                // Shading is deferred to `shadeVisibleTile`, only remember which triangle won.
+                                const ids_in: IdLanes = id_block[index..][0..lanes].*;
+                                id_block[index..][0..lanes].* = @select(u32, pass, @as(IdLanes, @splat(triangle_index)), ids_in);
+                            } else {
+                                const colors_in: ColorLanes = color_words[index..][0..lanes].*;
+                                const colors_out = self.shadeLanes(tri, weights, z, pass);
+                                color_words[index..][0..lanes].* = @select(u32, pass, colors_out, colors_in);
+                                stats.fragments_shaded += countLanes(pass);
+                                if (self.render_mode == .overdraw and !self.prepass) {
+                                    countOverdraw(overdraw_block[index..][0..lanes], pass);
+                                }
+                            }
+
+                            // After the pre-pass, passing fragments already hold the final depth.
+                            if (pass_kind != .shade) {
+                                depth_block[index..][0..lanes].* = @select(f32, pass, rev_z, depth);
+                                block_written = true;
+                            }
+                        }
+
+                        inline for (0..3) |i| {
+                            row_edges[i] += @as(EdgeLanes, @splat(tri.edges[i].step_y));
+                        }
+                    }
+
+                    if (block_written) {
+                        self.updateHiZBlock(tile_index, block_x, block_y);
+                        tile_changed = true;
+                    }
+                }
+            }
+
+            if (tile_changed) {
+                self.updateHiZTile(tile_index);
+            }
+        }
+    }
+
+    /// Second pass of the visibility buffer: run `fragmentShader` exactly once for every pixel of the tile
+    /// won by a triangle of the current `draw`, reconstructing its barycentrics from the triangle's edges.
+    fn shadeVisibleTile(self: *Graphics, tile_index: usize, stats: *Statistics) void {
+        const ts = self.tile_size;
+        const tile_x0 = (tile_index % self.tiles_x) * ts;
+        const tile_y0 = (tile_index / self.tiles_x) * ts;
+        const tile_w = @min(ts, self.width - tile_x0);
+        const tile_h = @min(ts, self.height - tile_y0);
+        const color_words: []u32 = @ptrCast(self.tile_color_buffer[tile_index * ts * ts ..][0 .. ts * ts]);
+        const id_block = self.id_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+        const lane_offsets = std.simd.iota(usize, lanes);
+        const none: MaskLanes = @splat(false);
+
+        for (0..tile_h) |ly| {
+            const y = tile_y0 + ly;
+
+            var lx: usize = 0;
+            while (lx < tile_w) : (lx += lanes) {
+                const index = ly * ts + lx;
+                const ids: IdLanes = id_block[index..][0..lanes].*;
+                const ids_array: [lanes]u32 = ids;
+                const xs = @as(IndexLanes, @splat(tile_x0 + lx)) + lane_offsets;
+
+                var remaining = maskAnd(ids != @as(IdLanes, @splat(no_triangle)), @as(IndexLanes, @splat(lx)) + lane_offsets < @as(IndexLanes, @splat(tile_w)));
+                var colors: ColorLanes = color_words[index..][0..lanes].*;
+
+                // Lanes usually belong to one or two triangles, shade them one triangle at a time.
+                while (std.simd.firstTrue(remaining)) |lane| {
+                    const triangle_index = ids_array[lane];
+                    const tri = &self.triangles.items[triangle_index];
+                    const mask = maskAnd(remaining, ids == @as(IdLanes, @splat(triangle_index)));
+
+                    const edges = tri.edgesAt(xs, y);
+                    const weights = barycentrics(tri, edges, mask);
+                    const z = interpolatedDepth(tri, weights);
+
+                    colors = @select(u32, mask, self.shadeLanes(tri, weights, z, mask), colors);
+                    stats.fragments_shaded += countLanes(mask);
+                    remaining = @select(bool, mask, none, remaining);
                 }
+
+                color_words[index..][0..lanes].* = colors;
             }
         }
     }
 
+    /// Barycentric weights of the lanes in `mask` from their edge function values, other lanes are zero so
+    /// they never produce NaN or infinite values.
+    inline fn barycentrics(tri: *const Triangle, edges: [3]EdgeLanes, mask: MaskLanes) [3]FloatLanes {
+        const zero: FloatLanes = @splat(0.0);
+        const inv_area: FloatLanes = @splat(tri.inv_area);
+        var weights: [3]FloatLanes = undefined;
+
+        inline for (0..3) |i| {
+            const w: FloatLanes = @floatFromInt(edges[i]);
+            weights[i] = @select(f32, mask, w * inv_area, zero);
+        }
+
+        return weights;
+    }
+
+    /// Interpolated inverse depth.
+    inline fn interpolatedDepth(tri: *const Triangle, weights: [3]FloatLanes) FloatLanes {
+        return weights[0] * @as(FloatLanes, @splat(tri.v0.z)) +
+            weights[1] * @as(FloatLanes, @splat(tri.v1.z)) +
+            weights[2] * @as(FloatLanes, @splat(tri.v2.z));
+    }
+
+    /// Interpolate the attributes of `tri` and run `fragmentShader` for the lanes in `mask`.
+    inline fn shadeLanes(self: *const Graphics, tri: *const Triangle, weights: [3]FloatLanes, z: FloatLanes, mask: MaskLanes) ColorLanes {
+        const b0 = weights[0];
+        const b1 = weights[1];
+        const b2 = weights[2];
+        const inv_z = @select(f32, mask, @as(FloatLanes, @splat(1.0)) / z, @as(FloatLanes, @splat(0.0)));
+
+        const u = interpolateLanes(tri.t0.x, tri.t1.x, tri.t2.x, b0, b1, b2, inv_z);
+        const v = interpolateLanes(tri.t0.y, tri.t1.y, tri.t2.y, b0, b1, b2, inv_z);
+        const normal = [3]FloatLanes{
+            interpolateLanes(tri.n0.x, tri.n1.x, tri.n2.x, b0, b1, b2, inv_z),
+            interpolateLanes(tri.n0.y, tri.n1.y, tri.n2.y, b0, b1, b2, inv_z),
+            interpolateLanes(tri.n0.z, tri.n1.z, tri.n2.z, b0, b1, b2, inv_z),
+        };
+
+        return fragmentShader(self.render_mode, u, v, normal, self.draw_texture, tri.face_index);
+    }
+
+    /// Recompute the depth range of a block from `depth_buffer`, ignoring pixels outside of the screen.
+    fn updateHiZBlock(self: *Graphics, tile_index: usize, block_x: usize, block_y: usize) void {
+        const ts = self.tile_size;
+        const bs = hiz_block_size;
+        const blocks_per_row = ts / bs;
+        const local_x = block_x * bs;
+        const local_y = block_y * bs;
+        const screen_x = (tile_index % self.tiles_x) * ts + local_x;
+        const screen_y = (tile_index / self.tiles_x) * ts + local_y;
+        const valid_w = @min(bs, self.width - screen_x);
+        const valid_h = @min(bs, self.height - screen_y);
+        const depth_block = self.depth_buffer[tile_index * ts * ts ..][0 .. ts * ts];
+        const valid = std.simd.iota(usize, bs) < @as(@Vector(bs, usize), @splat(valid_w));
+
+        var nearest: HiZRow = @splat(std.math.inf(f32));
+        var farthest: HiZRow = @splat(-std.math.inf(f32));
+
+        for (local_y..local_y + valid_h) |y| {
+            const depth: HiZRow = depth_block[y * ts + local_x ..][0..bs].*;
+            nearest = @min(nearest, @select(f32, valid, depth, @as(HiZRow, @splat(std.math.inf(f32)))));
+            farthest = @max(farthest, @select(f32, valid, depth, @as(HiZRow, @splat(-std.math.inf(f32)))));
+        }
+
+        const hiz_index = tile_index * blocks_per_row * blocks_per_row + block_x + block_y * blocks_per_row;
+        self.hiz_min[hiz_index] = @reduce(.Min, nearest);
+        self.hiz_max[hiz_index] = @reduce(.Max, farthest);
+    }
+
+    /// Recompute the farthest depth of a tile from its on-screen blocks.
+    fn updateHiZTile(self: *Graphics, tile_index: usize) void {
+        const ts = self.tile_size;
+        const bs = hiz_block_size;
+        const blocks_per_row = ts / bs;
+        const tile_w = @min(ts, self.width - (tile_index % self.tiles_x) * ts);
+        const tile_h = @min(ts, self.height - (tile_index / self.tiles_x) * ts);
+        const hiz_max = self.hiz_max[tile_index * blocks_per_row * blocks_per_row ..][0 .. blocks_per_row * blocks_per_row];
+
+        var farthest = -std.math.inf(f32);
+        for (0..(tile_h + bs - 1) / bs) |block_y| {
+            for (hiz_max[block_y * blocks_per_row ..][0 .. (tile_w + bs - 1) / bs]) |depth| {
+                farthest = @max(farthest, depth);
+            }
+        }
+        self.tile_depth_max[tile_index] = farthest;
+    }
+
     const colors: [7]Color = .{
         Color.gray(30),
         Color.gray(54),
@@ -458,23 +2055,23 @@ pub const Graphics = struct {
         Color.gray(140),
     };
 
+    /// Shade a row of `lanes` fragments belonging to the same face.
     inline fn fragmentShader(
         mode: Settings.RenderMode,
-        uv: Vector2,
-        normal: Vector3,
+        u: FloatLanes,
+        v: FloatLanes,
+        normal: [3]FloatLanes,
         texture: ?Texture,
         index: usize,
-    ) Color {
-        const color = switch (mode) {
-            .texture => if (texture) |t|
-                t.sample(uv, .{ .repeat = true })
-            else
-                fragmentShader(.color, uv, normal, texture, index),
-            .color => a: {
-                break :a colors[index % colors.len];
-            },
-        };
+    ) ColorLanes {
+        _ = normal;
+
+        if (mode == .texture) {
+            if (texture) |t| {
+                return t.sampleLanes(lanes, u, v, .{ .repeat = true });
+            }
+        }
 
-        return color;
+        return @splat(@as(u32, @bitCast(colors[index % colors.len])));
     }
 };
@@ -0,0 +1,103 @@
+//! Frame time distribution of the viewer, split into the CPU time rendering a frame and the time presenting it
+//! or waiting for the next one. Percentiles are logged on exit and, with a `path`, regularly written as a
+//! Prometheus textfile so long sessions can be watched with node_exporter's textfile collector.
+
+const std = @import("std");
+const Histogram = @import("Histogram.zig");
+
+const Telemetry = @This();
+
+/// Whole session, reported on exit and as the sums and counts of the textfile.
+render: Histogram = .{},
+present: Histogram = .{},
+/// Since the previous export, the quantiles of the textfile only cover these so they follow regressions.
+window_render: Histogram = .{},
+window_present: Histogram = .{},
+/// Textfile to write, `null` disables the export.
+path: ?[]const u8,
+/// Nanoseconds between two exports.
+interval: u64,
+/// Time of the previous export, in the same clock as `record`.
+last_export: u64 = 0,
+
+const quantiles = [_]f64{ 0.5, 0.9, 0.99 };
+
+pub fn init(path: ?[]const u8, interval_seconds: u32) Telemetry {
+    return .{
+        .path = path,
+        .interval = @as(u64, interval_seconds) * std.time.ns_per_s,
+    };
+}
+
+/// Add the times of one frame, `now` is in nanoseconds on any monotonic clock.
+pub fn record(self: *Telemetry, render_time: u64, present_time: u64, now: u64) void {
+    self.render.record(render_time);
+    self.present.record(present_time);
+    self.window_render.record(render_time);
+    self.window_present.record(present_time);
+
+    if (self.path) |path| {
+        if (now - self.last_export >= self.interval) {
+            self.last_export = now;
+            self.writeTextfile(path) catch |err| {
+                std.log.err("unable to write the telemetry to {s}: {}", .{ path, err });
+            };
+            self.window_render.reset();
+            self.window_present.reset();
+        }
+    }
+}
+
+/// Log the percentiles of the whole session.
+pub fn report(self: *const Telemetry) void {
+    inline for (.{ "render", "present" }) |name| {
+        const histogram = &@field(self, name);
+        std.log.info("{s} time over {} frames: p50 {d:.2} ms, p90 {d:.2} ms, p99 {d:.2} ms, max {d:.2} ms", .{
+            name,
+            histogram.count,
+            milliseconds(histogram.percentile(0.5)),
+            milliseconds(histogram.percentile(0.9)),
+            milliseconds(histogram.percentile(0.99)),
+            milliseconds(histogram.max),
+        });
+    }
+}
+
+/// Write to a temporary file renamed over `path`, so the collector never reads a partial file.
+fn writeTextfile(self: *const Telemetry, path: []const u8) !void {
+    var tmp_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const tmp_path = try std.fmt.bufPrint(&tmp_buffer, "{s}.tmp", .{path});
+
+    {
+        const file = try std.fs.cwd().createFile(tmp_path, .{});
+        defer file.close();
+
+        var buffered = std.io.bufferedWriter(file.writer());
+        const writer = buffered.writer();
+
+        try writeSummary(writer, "scop_frame_render_seconds", "CPU time clearing and drawing a frame.", &self.render, &self.window_render);
+        try writeSummary(writer, "scop_frame_present_seconds", "Time presenting a frame and waiting for the next one.", &self.present, &self.window_present);
+        try buffered.flush();
+    }
+
+    try std.fs.cwd().rename(tmp_path, path);
+}
+
+fn writeSummary(writer: anytype, name: []const u8, help: []const u8, total: *const Histogram, window: *const Histogram) !void {
+    try writer.print("# HELP {s} {s}\n# TYPE {s} summary\n", .{ name, help, name });
+    for (quantiles) |quantile| {
+        try writer.print("{s}{{quantile=\"{d}\"}} {d:.6}\n", .{ name, quantile, seconds(window.percentile(quantile)) });
+    }
+    try writer.print("{s}_sum {d:.6}\n{s}_count {}\n", .{ name, seconds(total.sum), name, total.count });
+
+    try writer.print("# HELP {s}_max Longest frame since the previous export.\n# TYPE {s}_max gauge\n", .{ name, name });
+    try writer.print("{s}_max {d:.6}\n", .{ name, seconds(window.max) });
+}
+
+fn milliseconds(ns: u64) f64 {
+    return @as(f64, @floatFromInt(ns)) / std.time.ns_per_ms;
+}
+
+fn seconds(ns: u64) f64 {
+    return @as(f64, @floatFromInt(ns)) / std.time.ns_per_s;
+}
@@ -1,4 +1,5 @@
 const std = @import("std");
+const profile = @import("profile.zig");
 
 const Allocator = std.mem.Allocator;
 const ArrayList = std.ArrayList;
@@ -119,6 +120,9 @@ pub fn loadFromFile(
     path: []const u8,
     allocator: Allocator,
 ) !Texture {
+    const zone = profile.begin("load texture");
+    defer zone.end();
+
     const file = try std.fs.cwd().openFile(path, .{});
     defer file.close();
 
@@ -171,3 +175,36 @@ pub inline fn sample(self: *const Texture, uv: Vector2, options: SampleOptions)
 
     return self.buffer.items[x + y * self.width];
 }
+
+/// Same as `sample` for `n` texels at once. Texels are gathered one lane at a time.
+pub inline fn sampleLanes(
+    self: *const Texture,
+    comptime n: usize,
+    u: @Vector(n, f32),
+    v: @Vector(n, f32),
+    options: SampleOptions,
+) @Vector(n, u32) {
+    @setRuntimeSafety(false);
+
+    const Lanes = @Vector(n, f32);
+    const Indices = @Vector(n, u32);
+    const zero: Lanes = @splat(0.0);
+    const one: Lanes = @splat(1.0);
+
+    const uv_x = if (options.repeat) u - @floor(u) else @min(@max(u, zero), one);
+    const uv_y = if (options.repeat) v - @floor(v) else @min(@max(v, zero), one);
+
+    const max_x: Lanes = @splat(@floatFromInt(self.width - 1));
+    const max_y: Lanes = @splat(@floatFromInt(self.height - 1));
+
+    const x: Indices = @intFromFloat(@min(uv_x * max_x, max_x));
+    const y: Indices = @intFromFloat(@min(uv_y * max_y, max_y));
+    const index = x + (@as(Indices, @splat(@intCast(self.height - 1))) - y) * @as(Indices, @splat(@intCast(self.width)));
+
+    var texels: Indices = undefined;
+    inline for (0..n) |i| {
+        texels[i] = @bitCast(self.buffer.items[index[i]]);
+    }
+
+    return texels;
+}
@@ -0,0 +1,305 @@
+//! Renders fixed turntable paths over the bundled models at several resolutions with the headless renderer,
+//! and reports throughput and frame times as JSON, optionally compared against a saved baseline.
+//! Also measures the OBJ parser on every model, on one thread and on every core.
+
+const std = @import("std");
+const argzon = @import("argzon");
+
+const Mesh = @import("Mesh.zig");
+const obj = @import("obj.zig");
+const Settings = @import("Settings.zig");
+const HeadlessRenderer = @import("HeadlessRenderer.zig");
+
+var gpa: std.heap.DebugAllocator(.{}) = .init;
+
+const @"import(cli.zon)" = .{
+    .name = .@"scop-bench",
+    .description = "Software renderer benchmark",
+    .options = .{
+        .{
+            .short = 'n',
+            .long = "frames",
+            .type = "?string",
+            .description = "Number of frames rendered per case (default: 120)",
+        },
+        .{
+            .short = 'o',
+            .long = "output",
+            .type = "?string",
+            .description = "Write the JSON results to a file instead of the standard output",
+        },
+        .{
+            .short = 'b',
+            .long = "baseline",
+            .type = "?string",
+            .description = "Compare against the JSON results of a previous run",
+        },
+    },
+    .flags = .{},
+    .positionals = .{},
+};
+
+const resolutions = [_][2]usize{
+    .{ 640, 360 },
+    .{ 1280, 720 },
+    .{ 1920, 1080 },
+};
+
+/// Results of one model at one resolution.
+const Result = struct {
+    model: []const u8,
+    width: usize,
+    height: usize,
+    frames: usize,
+    mean_ms: f64,
+    p99_ms: f64,
+    triangles_per_second: f64,
+    pixels_shaded_per_second: f64,
+};
+
+/// Parse time of one model from memory, disk access excluded.
+const LoadResult = struct {
+    model: []const u8,
+    bytes: usize,
+    /// `0` for every core.
+    threads: usize,
+    mean_ms: f64,
+    megabytes_per_second: f64,
+    /// Building the vertex and index buffers after parsing, not included in `mean_ms`.
+    /// `0` in baselines recorded before it was measured.
+    vertex_buffer_ms: f64 = 0,
+};
+
+const Results = struct {
+    results: []const Result,
+    loads: []const LoadResult = &.{},
+};
+
+/// Parses timed per model and thread count.
+const load_repeats = 10;
+
+pub fn main() !void {
+    const allocator = gpa.allocator();
+
+    const Args = argzon.Args(@"import(cli.zon)", &.{});
+    const args = try Args.parse(allocator, std.io.getStdErr().writer(), .{});
+
+    const frames = args.options.frames orelse "120";
+    const frame_count = std.fmt.parseInt(usize, frames, 10) catch 0;
+    if (frame_count == 0) {
+        std.log.err("invalid frame count: {s}", .{frames});
+        return;
+    }
+
+    var arena_state = std.heap.ArenaAllocator.init(allocator);
+    defer arena_state.deinit();
+    const arena = arena_state.allocator();
+
+    const models = try listModels(arena);
+    var results = std.ArrayList(Result).init(arena);
+    var loads = std.ArrayList(LoadResult).init(arena);
+
+    for (models) |model_path| {
+        for ([_]usize{ 1, 0 }) |threads| {
+            const load = benchmarkLoad(allocator, model_path, threads) catch |err| {
+                std.log.err("unable to parse {s}: {}", .{ model_path, err });
+                break;
+            };
+            std.log.info("{s} parse ({s}): mean {d:.2} ms, {d:.1} MB/s, vertex buffer {d:.2} ms", .{
+                load.model,
+                if (threads == 1) "1 thread" else "all cores",
+                load.mean_ms,
+                load.megabytes_per_second,
+                load.vertex_buffer_ms,
+            });
+            try loads.append(load);
+        }
+    }
+
+    for (models) |model_path| {
+        const mesh = Mesh.loadFromFile(model_path, allocator) catch |err| {
+            std.log.err("unable to load {s}: {}", .{ model_path, err });
+            continue;
+        };
+        defer mesh.deinit();
+
+        for (resolutions) |resolution| {
+            const result = try benchmark(allocator, model_path, mesh, resolution[0], resolution[1], frame_count);
+            std.log.info("{s} {}x{}: mean {d:.2} ms, p99 {d:.2} ms, {d:.0} triangles/s, {d:.0} pixels/s", .{
+                result.model,
+                result.width,
+                result.height,
+                result.mean_ms,
+                result.p99_ms,
+                result.triangles_per_second,
+                result.pixels_shaded_per_second,
+            });
+            try results.append(result);
+        }
+    }
+
+    if (args.options.baseline) |path| {
+        compare(arena, path, results.items, loads.items) catch |err| {
+            std.log.err("unable to compare with {s}: {}", .{ path, err });
+        };
+    }
+
+    const output = Results{ .results = results.items, .loads = loads.items };
+    if (args.options.output) |path| {
+        const file = try std.fs.cwd().createFile(path, .{});
+        defer file.close();
+        try std.json.stringify(output, .{ .whitespace = .indent_2 }, file.writer());
+    } else {
+        try std.json.stringify(output, .{ .whitespace = .indent_2 }, std.io.getStdOut().writer());
+    }
+}
+
+/// `models/42.obj`, `models/teapot*.obj` and every `models/medieval/*.obj`, in a stable order.
+fn listModels(arena: std.mem.Allocator) ![]const []const u8 {
+    var models = std.ArrayList([]const u8).init(arena);
+    try models.append("models/42.obj");
+
+    const directories = [_]struct { path: []const u8, prefix: []const u8 }{
+        .{ .path = "models", .prefix = "teapot" },
+        .{ .path = "models/medieval", .prefix = "" },
+    };
+
+    for (directories) |directory| {
+        var dir = try std.fs.cwd().openDir(directory.path, .{ .iterate = true });
+        defer dir.close();
+
+        const start = models.items.len;
+        var it = dir.iterate();
+        while (try it.next()) |entry| {
+            if (entry.kind == .file and std.mem.startsWith(u8, entry.name, directory.prefix) and std.mem.endsWith(u8, entry.name, ".obj")) {
+                try models.append(try std.fs.path.join(arena, &.{ directory.path, entry.name }));
+            }
+        }
+
+        std.mem.sort([]const u8, models.items[start..], {}, lessThan);
+    }
+
+    return models.items;
+}
+
+fn lessThan(_: void, a: []const u8, b: []const u8) bool {
+    return std.mem.lessThan(u8, a, b);
+}
+
+/// Parse `model_path` from memory `load_repeats` times, then build its vertex buffer, timed apart so the parse
+/// rate stays comparable with baselines recorded before the vertex buffer existed.
+fn benchmarkLoad(allocator: std.mem.Allocator, model_path: []const u8, threads: usize) !LoadResult {
+    const data = try std.fs.cwd().readFileAlloc(allocator, model_path, std.math.maxInt(usize));
+    defer allocator.free(data);
+
+    var parse_time: u64 = 0;
+    var vertex_buffer_time: u64 = 0;
+    var timer = try std.time.Timer.start();
+    for (0..load_repeats) |_| {
+        timer.reset();
+        var mesh = try obj.parse(allocator, data, .{ .thread_count = threads, .build_vertex_buffer = false });
+        defer mesh.deinit();
+        parse_time += timer.lap();
+
+        try mesh.buildVertexBuffer();
+        vertex_buffer_time += timer.read();
+    }
+    const seconds = @as(f64, @floatFromInt(parse_time)) / std.time.ns_per_s / load_repeats;
+
+    return .{
+        .model = model_path,
+        .bytes = data.len,
+        .threads = threads,
+        .mean_ms = seconds * std.time.ms_per_s,
+        .megabytes_per_second = @as(f64, @floatFromInt(data.len)) / 1_000_000.0 / seconds,
+        .vertex_buffer_ms = @as(f64, @floatFromInt(vertex_buffer_time)) / std.time.ns_per_ms / load_repeats,
+    };
+}
+
+/// Render one full turn of `mesh`, framed to fill most of the screen.
+fn benchmark(allocator: std.mem.Allocator, model_path: []const u8, mesh: Mesh, width: usize, height: usize, frame_count: usize) !Result {
+    const bounds = mesh.getBounds();
+    const center = bounds.min.add(bounds.max).scale(0.5);
+    const size = bounds.max.sub(bounds.min).length();
+
+    var settings = Settings{
+        .window_width = width,
+        .window_height = height,
+        .render_mode = .color,
+        .enable_rotation = true,
+        .rotation_speed = 2.0 * std.math.pi / @as(f32, @floatFromInt(frame_count)),
+    };
+    const distance = size / (2.0 * @tan(std.math.degreesToRadians(settings.fov * 0.5))) + size * 0.5;
+    settings.model_x = -center.x;
+    settings.model_y = -center.y;
+    settings.model_z = -center.z - distance;
+
+    const renderer = HeadlessRenderer.init(allocator, settings, mesh, null, .{ .frame_count = frame_count });
+    var report = try renderer.render();
+    defer report.deinit(allocator);
+
+    const times = report.frame_times;
+    std.mem.sort(u64, times, {}, std.sort.asc(u64));
+
+    const total_seconds = @as(f64, @floatFromInt(report.totalTime())) / std.time.ns_per_s;
+    const p99_index = (times.len * 99 + 99) / 100 - 1;
+
+    return .{
+        .model = model_path,
+        .width = width,
+        .height = height,
+        .frames = frame_count,
+        .mean_ms = total_seconds * std.time.ms_per_s / @as(f64, @floatFromInt(frame_count)),
+        .p99_ms = @as(f64, @floatFromInt(times[p99_index])) / std.time.ns_per_ms,
+        .triangles_per_second = @as(f64, @floatFromInt(report.triangle_count)) / total_seconds,
+        .pixels_shaded_per_second = @as(f64, @floatFromInt(report.stats.fragments_shaded)) / total_seconds,
+    };
+}
+
+/// Print the change of every case also present in the baseline, negative times are improvements.
+fn compare(arena: std.mem.Allocator, path: []const u8, results: []const Result, loads: []const LoadResult) !void {
+    const data = try std.fs.cwd().readFileAlloc(arena, path, 100_000_000);
+    const baseline = try std.json.parseFromSliceLeaky(Results, arena, data, .{ .ignore_unknown_fields = true });
+
+    for (results) |result| {
+        for (baseline.results) |base| {
+            if (!std.mem.eql(u8, base.model, result.model) or base.width != result.width or base.height != result.height) {
+                continue;
+            }
+
+            std.log.info("{s} {}x{}: mean {d:.1}%, p99 {d:.1}%, pixels/s {d:.1}%", .{
+                result.model,
+                result.width,
+                result.height,
+                change(base.mean_ms, result.mean_ms),
+                change(base.p99_ms, result.p99_ms),
+                change(base.pixels_shaded_per_second, result.pixels_shaded_per_second),
+            });
+        }
+    }
+
+    for (loads) |load| {
+        for (baseline.loads) |base| {
+            if (!std.mem.eql(u8, base.model, load.model) or base.threads != load.threads) {
+                continue;
+            }
+
+            std.log.info("{s} parse ({s}): MB/s {d:.1}%", .{
+                load.model,
+                if (load.threads == 1) "1 thread" else "all cores",
+                change(base.megabytes_per_second, load.megabytes_per_second),
+            });
+            if (base.vertex_buffer_ms > 0) {
+                std.log.info("{s} vertex buffer ({s}): mean {d:.1}%", .{
+                    load.model,
+                    if (load.threads == 1) "1 thread" else "all cores",
+                    change(base.vertex_buffer_ms, load.vertex_buffer_ms),
+                });
+            }
+        }
+    }
+}
+
+fn change(before: f64, after: f64) f64 {
+    return (after - before) / before * 100.0;
+}
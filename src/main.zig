@@ -2,9 +2,11 @@ const std = @import("std");
 const mlx = @import("mlx");
 const argzon = @import("argzon");
 const math = @import("math.zig");
+const profile = @import("profile.zig");
 
 const SoftwareRenderer = @import("SoftwareRenderer.zig");
 const OpenGLRenderer = @import("OpenGLRenderer.zig");
+const HeadlessRenderer = @import("HeadlessRenderer.zig");
 
 const Mesh = @import("Mesh.zig");
 const Texture = @import("Texture.zig");
@@ -32,6 +34,24 @@ const @"import(cli.zon)" = .{
             .type = "?string",
             .description = "Use a different configuration file",
         },
+        .{
+            .short = 'n',
+            .long = "frames",
+            .type = "?string",
+            .description = "Number of frames rendered in headless mode (default: 1)",
+        },
+        .{
+            .short = 'o',
+            .long = "output",
+            .type = "?string",
+            .description = "Directory the headless frames are written to, discarded otherwise",
+        },
+        .{
+            .short = 'f',
+            .long = "format",
+            .type = "?string",
+            .description = "Image format of the headless frames (tga, ppm)",
+        },
     },
     .flags = .{
         // .{
@@ -39,6 +59,10 @@ const @"import(cli.zon)" = .{
         //     .long = "raw",
         //     .description = "Output raw values (otherwise, ZON).",
         // },
+        .{
+            .long = "headless",
+            .description = "Render with the software renderer without opening a window",
+        },
     },
     .positionals = .{
         .{
@@ -58,6 +82,14 @@ const @"import(cli.zon)" = .{
 pub fn main() !void {
     const allocator = gpa.allocator();
 
+    profile.init();
+    defer {
+        profile.writeTrace("scop-trace.json") catch |err| {
+            std.log.err("unable to write the trace: {}", .{err});
+        };
+        profile.deinit();
+    }
+
     const Args = argzon.Args(@"import(cli.zon)", &.{});
     const args = try Args.parse(allocator, std.io.getStdErr().writer(), .{});
 
@@ -96,10 +128,32 @@ pub fn main() !void {
     else
         null;
 
+    if (args.flags.headless) {
+        const frames = args.options.frames orelse "1";
+        const frame_count = std.fmt.parseInt(usize, frames, 10) catch 0;
+        if (frame_count == 0) {
+            std.log.err("invalid frame count: {s}", .{frames});
+            return;
+        }
+        const format_name = args.options.format orelse "tga";
+        const format = std.meta.stringToEnum(HeadlessRenderer.ImageFormat, format_name) orelse {
+            std.log.err("invalid image format: {s}", .{format_name});
+            return;
+        };
+
+        const renderer = HeadlessRenderer.init(allocator, settings, model, texture, .{
+            .frame_count = frame_count,
+            .output_dir = args.options.output,
+            .format = format,
+        });
+        try renderer.run();
+        return;
+    }
+
     const stderr = std.io.getStdOut().writer();
     nosuspend try stderr.print(
         \\
-        \\F1           - Toggle rendering mode
+        \\F1           - Cycle rendering mode (color, texture, overdraw, cost)
         \\F2           - Toggle lighting
         \\Space        - Toggle rotation
         \\Up / Down    - Move the object on the Y axis
@@ -4,7 +4,7 @@ const cos = std.math.cos;
 const sin = std.math.sin;
 const tan = std.math.tan;
 
-pub const Vector2 = struct {
+pub const Vector2 = extern struct {
     x: f32 = 0.0,
     y: f32 = 0.0,
 
@@ -35,7 +35,7 @@ pub const Vector2 = struct {
     }
 };
 
-pub const Vector3 = struct {
+pub const Vector3 = extern struct {
     x: f32 = 0.0,
     y: f32 = 0.0,
     z: f32 = 0.0,
@@ -332,6 +332,19 @@ pub const Matrix4 = struct {
         };
     }
 
+    /// Transform `n` points at once, given as one vector per coordinate.
+    /// Returns the `x`, `y`, `z` and `w` components before the perspective divide.
+    pub inline fn mulLanes(m: *const Matrix4, comptime n: usize, x: @Vector(n, f32), y: @Vector(n, f32), z: @Vector(n, f32)) [4]@Vector(n, f32) {
+        const V = @Vector(n, f32);
+
+        return .{
+            @as(V, @splat(m.m00)) * x + @as(V, @splat(m.m10)) * y + @as(V, @splat(m.m20)) * z + @as(V, @splat(m.m30)),
+            @as(V, @splat(m.m01)) * x + @as(V, @splat(m.m11)) * y + @as(V, @splat(m.m21)) * z + @as(V, @splat(m.m31)),
+            @as(V, @splat(m.m02)) * x + @as(V, @splat(m.m12)) * y + @as(V, @splat(m.m22)) * z + @as(V, @splat(m.m32)),
+            @as(V, @splat(m.m03)) * x + @as(V, @splat(m.m13)) * y + @as(V, @splat(m.m23)) * z + @as(V, @splat(m.m33)),
+        };
+    }
+
     pub inline fn mulVector3(m: *const Matrix4, v: Vector3) Vector3 {
         const w = m.m03 * v.x + m.m13 * v.y + m.m23 * v.z + m.m33;
 
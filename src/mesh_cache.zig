@@ -0,0 +1,239 @@
+//! Binary cache of parsed meshes, stored as `$XDG_CACHE_HOME/scop/<hash of the source path>.scopmesh`.
+//!
+//! The arrays of the mesh are written as they are in memory after a fixed header, so a cached mesh is mapped and
+//! used in place: loading it costs a few system calls whatever its size. An entry is only used when the size and
+//! modification time of the source file still match the ones it was created from.
+//!
+//! Loading never reads the arrays, that would touch every page of the file. Their indices are checked once by
+//! `store`, and a file only appears complete under its final name, so loads only check the header against the size
+//! of the file.
+
+const std = @import("std");
+const math = @import("math.zig");
+
+const Allocator = std.mem.Allocator;
+const Vector2 = math.Vector2;
+const Vector3 = math.Vector3;
+const Mesh = @import("Mesh.zig");
+const Face = Mesh.Face;
+const Vertex = Mesh.Vertex;
+
+/// Bumped whenever the layout of the file or of the arrays changes.
+const version = 2;
+const extension = ".scopmesh";
+const magic = "SCOPMESH".*;
+/// Arrays start on this alignment, at least the alignment of their elements.
+const array_alignment = 16;
+const array_count = 6;
+
+const Header = extern struct {
+    magic: [8]u8 = magic,
+    version: u32 = version,
+    reserved: u32 = 0,
+    source_size: u64,
+    /// Nanoseconds since the epoch.
+    source_mtime: i64,
+    vertex_count: u64,
+    texture_coord_count: u64,
+    normal_count: u64,
+    face_count: u64,
+    vertex_buffer_count: u64,
+    index_buffer_count: u64,
+
+    /// Offset of every array in the file, then the size of the file.
+    /// `null` when the counts are too large for any file, as read from a damaged one.
+    fn layout(self: *const Header) ?[array_count + 1]u64 {
+        const counts = [array_count]u64{
+            self.vertex_count,
+            self.texture_coord_count,
+            self.normal_count,
+            self.face_count,
+            self.vertex_buffer_count,
+            self.index_buffer_count,
+        };
+        const element_sizes = [array_count]u64{
+            @sizeOf(Vector3),
+            @sizeOf(Vector2),
+            @sizeOf(Vector3),
+            @sizeOf(Face),
+            @sizeOf(Vertex),
+            @sizeOf(u32),
+        };
+
+        var offsets: [array_count + 1]u64 = undefined;
+        var offset: u64 = @sizeOf(Header);
+        for (counts, element_sizes, 0..) |count, element_size, i| {
+            const size = std.math.mul(u64, count, element_size) catch return null;
+            const aligned = std.math.add(u64, offset, array_alignment - 1) catch return null;
+            offsets[i] = std.mem.alignBackward(u64, aligned, array_alignment);
+            offset = std.math.add(u64, offsets[i], size) catch return null;
+        }
+        offsets[array_count] = offset;
+        return offsets;
+    }
+};
+
+comptime {
+    // Cached arrays are reinterpreted as is, their elements must not have any padding.
+    std.debug.assert(@sizeOf(Vector2) == 2 * @sizeOf(f32));
+    std.debug.assert(@sizeOf(Vector3) == 3 * @sizeOf(f32));
+    std.debug.assert(@sizeOf(Face) == 9 * @sizeOf(u32));
+    std.debug.assert(@sizeOf(Vertex) == 8 * @sizeOf(f32));
+}
+
+/// Map the cached mesh of `source_path`, `null` when there is none or it is out of date.
+/// The returned mesh is unmapped by `Mesh.deinit`.
+pub fn load(gpa: Allocator, source_path: []const u8) !?Mesh {
+    var path_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const cache_path = try cachePath(&path_buffer, source_path) orelse return null;
+
+    const source = try std.fs.cwd().statFile(source_path);
+
+    const file = std.fs.cwd().openFile(cache_path, .{}) catch |err| switch (err) {
+        error.FileNotFound => return null,
+        else => return err,
+    };
+    defer file.close();
+
+    const size = (try file.stat()).size;
+    if (size < @sizeOf(Header)) {
+        return null;
+    }
+
+    // Read-only, writing to the mesh faults instead of silently diverging from the file.
+    const data = try std.posix.mmap(null, @intCast(size), std.posix.PROT.READ, .{ .TYPE = .PRIVATE }, file.handle, 0);
+    errdefer std.posix.munmap(data);
+
+    const header: *const Header = @ptrCast(data.ptr);
+
+    if (!std.mem.eql(u8, &header.magic, &magic) or
+        header.version != version or
+        header.source_size != source.size or
+        header.source_mtime != @as(i64, @truncate(source.mtime)))
+    {
+        std.posix.munmap(data);
+        return null;
+    }
+
+    const offsets = header.layout() orelse {
+        std.posix.munmap(data);
+        return null;
+    };
+    if (offsets[array_count] > size or header.index_buffer_count % 3 != 0) {
+        std.posix.munmap(data);
+        return null;
+    }
+
+    return Mesh{
+        .vertices = view(Vector3, data, offsets[0], header.vertex_count),
+        .textureCoords = view(Vector2, data, offsets[1], header.texture_coord_count),
+        .normals = view(Vector3, data, offsets[2], header.normal_count),
+        .faces = view(Face, data, offsets[3], header.face_count),
+        .vertexBuffer = view(Vertex, data, offsets[4], header.vertex_buffer_count),
+        .indexBuffer = view(u32, data, offsets[5], header.index_buffer_count),
+        .allocator = gpa,
+        .mapping = data,
+    };
+}
+
+/// Whether every index of the faces and of the index buffer points into its array.
+fn indicesInRange(mesh: *const Mesh) bool {
+    const vertex_count = mesh.vertices.len;
+    const texture_coord_count = mesh.textureCoords.len;
+    const normal_count = mesh.normals.len;
+
+    for (mesh.faces) |face| {
+        if (std.mem.max(u32, &face.vertices) >= vertex_count or
+            std.mem.max(u32, &face.textures) >= texture_coord_count or
+            std.mem.max(u32, &face.normals) >= normal_count)
+        {
+            return false;
+        }
+    }
+
+    const indices = mesh.indexBuffer;
+    return indices.len % 3 == 0 and (indices.len == 0 or std.mem.max(u32, indices) < mesh.vertexBuffer.len);
+}
+
+/// Part of the mapping as an array of `T`.
+fn view(comptime T: type, data: []align(std.heap.page_size_min) const u8, offset: u64, count: u64) []const T {
+    const items: [*]const T = @ptrCast(@alignCast(data.ptr + @as(usize, @intCast(offset))));
+    return items[0..@intCast(count)];
+}
+
+/// Write `mesh` as the cached mesh of `source_path`.
+/// The file is written under a temporary name then renamed, so concurrent loads never see a partial file.
+pub fn store(mesh: *const Mesh, source_path: []const u8) !void {
+    // The renderers index the arrays without any check, and loads trust the cached indices.
+    if (!indicesInRange(mesh)) {
+        return error.IndexOutOfRange;
+    }
+
+    var path_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const cache_path = try cachePath(&path_buffer, source_path) orelse return;
+
+    const source = try std.fs.cwd().statFile(source_path);
+
+    try std.fs.cwd().makePath(std.fs.path.dirname(cache_path).?);
+
+    var tmp_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const tmp_path = try std.fmt.bufPrint(&tmp_buffer, "{s}.{}.tmp", .{ cache_path, std.os.linux.getpid() });
+
+    {
+        const file = try std.fs.cwd().createFile(tmp_path, .{});
+        defer file.close();
+        errdefer std.fs.cwd().deleteFile(tmp_path) catch {};
+
+        const header = Header{
+            .source_size = source.size,
+            .source_mtime = @truncate(source.mtime),
+            .vertex_count = mesh.vertices.len,
+            .texture_coord_count = mesh.textureCoords.len,
+            .normal_count = mesh.normals.len,
+            .face_count = mesh.faces.len,
+            .vertex_buffer_count = mesh.vertexBuffer.len,
+            .index_buffer_count = mesh.indexBuffer.len,
+        };
+        const offsets = header.layout().?;
+        const arrays = [_][]const u8{
+            std.mem.sliceAsBytes(mesh.vertices),
+            std.mem.sliceAsBytes(mesh.textureCoords),
+            std.mem.sliceAsBytes(mesh.normals),
+            std.mem.sliceAsBytes(mesh.faces),
+            std.mem.sliceAsBytes(mesh.vertexBuffer),
+            std.mem.sliceAsBytes(mesh.indexBuffer),
+        };
+
+        var buffered = std.io.bufferedWriter(file.writer());
+        const writer = buffered.writer();
+
+        try writer.writeAll(std.mem.asBytes(&header));
+        var written: u64 = @sizeOf(Header);
+        for (arrays, offsets[0..array_count]) |array, offset| {
+            try writer.writeByteNTimes(0, @intCast(offset - written));
+            try writer.writeAll(array);
+            written = offset + array.len;
+        }
+        try buffered.flush();
+    }
+
+    try std.fs.cwd().rename(tmp_path, cache_path);
+}
+
+/// `$XDG_CACHE_HOME/scop/<hash>.scopmesh`, or under `$HOME/.cache` when it is not set.
+/// `null` when neither is set.
+fn cachePath(buffer: []u8, source_path: []const u8) !?[]const u8 {
+    var real_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const real_path = try std.fs.cwd().realpath(source_path, &real_buffer);
+    const hash = std.hash.Wyhash.hash(0, real_path);
+
+    if (std.posix.getenv("XDG_CACHE_HOME")) |cache_home| {
+        if (cache_home.len > 0) {
+            return try std.fmt.bufPrint(buffer, "{s}/scop/{x:0>16}" ++ extension, .{ cache_home, hash });
+        }
+    }
+    if (std.posix.getenv("HOME")) |home| {
+        return try std.fmt.bufPrint(buffer, "{s}/.cache/scop/{x:0>16}" ++ extension, .{ home, hash });
+    }
+    return null;
+}
@@ -0,0 +1,682 @@
+//! Wavefront OBJ parser, splitting the file at line boundaries into chunks parsed on every core.
+//!
+//! A first pass counts the elements of every chunk, so each array is allocated once at its exact size and every
+//! chunk knows where its elements go. The second pass parses the chunks in place, resolving relative (negative)
+//! indices from the number of elements declared before each face. Polygons are triangulated as fans, and their
+//! corners finally deduplicated into the vertex and index buffers the renderers draw.
+//!
+//! Lines and tokens are found with vector compares, and numbers are decoded by specialized parsers, falling back to
+//! `std.fmt` for the floats with too many digits to be rounded exactly in one operation.
+
+const std = @import("std");
+const math = @import("math.zig");
+const parallel = @import("parallel.zig");
+
+const Allocator = std.mem.Allocator;
+const Vector2 = math.Vector2;
+const Vector3 = math.Vector3;
+const Mesh = @import("Mesh.zig");
+const Face = Mesh.Face;
+
+/// Bytes compared at once when looking for separators.
+const scan_lanes = std.simd.suggestVectorLength(u8) orelse 16;
+
+/// Bytes parsed by a chunk between two releases of its pages.
+const release_interval = 8 * 1024 * 1024;
+
+pub const Options = struct {
+    /// `0` uses every available core.
+    thread_count: usize = 0,
+    /// Smallest chunk worth a thread of its own.
+    min_chunk_size: usize = 256 * 1024,
+    /// Deduplicate the corners into the vertex and index buffers, see `Mesh.buildVertexBuffer`.
+    build_vertex_buffer: bool = true,
+    /// The data is a read-only file mapping, let the kernel drop its pages once parsed so the resident memory
+    /// stays close to the size of the mesh instead of the size of the file.
+    release_pages: bool = false,
+};
+
+/// Number of each element, in a chunk or before it.
+const Counts = struct {
+    vertices: usize = 0,
+    texture_coords: usize = 0,
+    normals: usize = 0,
+    /// Triangles, polygons count for their fan.
+    faces: usize = 0,
+
+    fn add(self: *Counts, other: Counts) void {
+        inline for (std.meta.fields(Counts)) |field| {
+            @field(self, field.name) += @field(other, field.name);
+        }
+    }
+};
+
+const Chunk = struct {
+    data: []const u8,
+    counts: Counts = .{},
+    /// Elements declared by the previous chunks, where this chunk writes its own.
+    offsets: Counts = .{},
+    err: ?anyerror = null,
+};
+
+const Parser = struct {
+    chunks: []Chunk,
+    release_pages: bool,
+    /// Elements declared by the whole file, indices are checked against them.
+    totals: Counts,
+    vertices: []Vector3,
+    texture_coords: []Vector2,
+    normals: []Vector3,
+    faces: []Face,
+};
+
+const Keyword = enum {
+    vertex,
+    texture_coords,
+    normal,
+    face,
+};
+
+pub fn parse(gpa: Allocator, data: []const u8, options: Options) !Mesh {
+    const thread_count = parallel.threadCount(options.thread_count);
+    const chunk_count = @max(1, @min(thread_count, data.len / @max(options.min_chunk_size, 1)));
+
+    const chunks = try gpa.alloc(Chunk, chunk_count);
+    defer gpa.free(chunks);
+
+    // Chunks end after a newline, so no line is split between two of them.
+    var start: usize = 0;
+    for (chunks, 0..) |*chunk, i| {
+        var end = if (i + 1 == chunk_count) data.len else @max(start, data.len / chunk_count * (i + 1));
+        if (end < data.len) {
+            end = @min(indexOfAnyPos(data, end, "\n") + 1, data.len);
+        }
+        chunk.* = .{ .data = data[start..end] };
+        start = end;
+    }
+
+    const pool = try parallel.initPool(gpa, chunk_count);
+    defer parallel.deinitPool(gpa, pool);
+
+    var parser = Parser{
+        .chunks = chunks,
+        .release_pages = options.release_pages,
+        .totals = .{},
+        .vertices = &.{},
+        .texture_coords = &.{},
+        .normals = &.{},
+        .faces = &.{},
+    };
+
+    parallel.forEach(pool, &parser, chunks.len, countChunk);
+
+    for (chunks) |*chunk| {
+        chunk.offsets = parser.totals;
+        parser.totals.add(chunk.counts);
+    }
+
+    // Faces without texture coordinates or normals point at a default one.
+    const vertices = try gpa.alloc(Vector3, parser.totals.vertices);
+    errdefer gpa.free(vertices);
+    const texture_coords = try gpa.alloc(Vector2, @max(parser.totals.texture_coords, 1));
+    errdefer gpa.free(texture_coords);
+    const normals = try gpa.alloc(Vector3, @max(parser.totals.normals, 1));
+    errdefer gpa.free(normals);
+    const faces = try gpa.alloc(Face, parser.totals.faces);
+    errdefer gpa.free(faces);
+
+    if (parser.totals.texture_coords == 0) texture_coords[0] = .{};
+    if (parser.totals.normals == 0) normals[0] = .{};
+
+    parser.vertices = vertices;
+    parser.texture_coords = texture_coords;
+    parser.normals = normals;
+    parser.faces = faces;
+
+    parallel.forEach(pool, &parser, chunks.len, parseChunk);
+
+    for (chunks) |chunk| {
+        if (chunk.err) |err| {
+            return err;
+        }
+    }
+
+    var mesh = Mesh{
+        .vertices = vertices,
+        .textureCoords = texture_coords,
+        .normals = normals,
+        .faces = faces,
+        .allocator = gpa,
+    };
+    if (options.build_vertex_buffer) {
+        try mesh.buildVertexBuffer();
+    }
+
+    return mesh;
+}
+
+fn keyword(text: []const u8) ?Keyword {
+    if (std.mem.eql(u8, text, "v")) return .vertex;
+    if (std.mem.eql(u8, text, "vt")) return .texture_coords;
+    if (std.mem.eql(u8, text, "vn")) return .normal;
+    if (std.mem.eql(u8, text, "f")) return .face;
+    return null;
+}
+
+/// First pass: count the elements of a chunk.
+fn countChunk(parser: *Parser, chunk_index: usize) void {
+    const chunk = &parser.chunks[chunk_index];
+    var counts = Counts{};
+    var pages = PageReleaser.init(chunk.data, parser.release_pages);
+
+    var lines = Lines{ .data = chunk.data };
+    while (lines.next()) |line| : (pages.advance(lines.pos)) {
+        var tokens = Tokens{ .line = line };
+        switch (keyword(tokens.next() orelse continue) orelse continue) {
+            .vertex => counts.vertices += 1,
+            .texture_coords => counts.texture_coords += 1,
+            .normal => counts.normals += 1,
+            .face => {
+                var corner_count: usize = 0;
+                while (tokens.next()) |_| corner_count += 1;
+                counts.faces += corner_count -| 2;
+            },
+        }
+    }
+
+    chunk.counts = counts;
+}
+
+/// Second pass: parse the elements of a chunk into their final place.
+fn parseChunk(parser: *Parser, chunk_index: usize) void {
+    const chunk = &parser.chunks[chunk_index];
+    parseLines(parser, chunk) catch |err| {
+        chunk.err = err;
+    };
+}
+
+fn parseLines(parser: *Parser, chunk: *const Chunk) !void {
+    // Elements declared so far, from the start of the file.
+    var declared = chunk.offsets;
+    var pages = PageReleaser.init(chunk.data, parser.release_pages);
+
+    var lines = Lines{ .data = chunk.data };
+    while (lines.next()) |line| : (pages.advance(lines.pos)) {
+        var tokens = Tokens{ .line = line };
+        switch (keyword(tokens.next() orelse continue) orelse continue) {
+            .vertex => {
+                parser.vertices[declared.vertices] = .{
+                    .x = try parseFloat(tokens.next() orelse return error.InvalidLine),
+                    .y = try parseFloat(tokens.next() orelse return error.InvalidLine),
+                    .z = try parseFloat(tokens.next() orelse return error.InvalidLine),
+                };
+                declared.vertices += 1;
+            },
+            .texture_coords => {
+                parser.texture_coords[declared.texture_coords] = .{
+                    .x = try parseFloat(tokens.next() orelse return error.InvalidLine),
+                    .y = try parseFloat(tokens.next() orelse return error.InvalidLine),
+                };
+                declared.texture_coords += 1;
+            },
+            .normal => {
+                parser.normals[declared.normals] = .{
+                    .x = try parseFloat(tokens.next() orelse return error.InvalidLine),
+                    .y = try parseFloat(tokens.next() orelse return error.InvalidLine),
+                    .z = try parseFloat(tokens.next() orelse return error.InvalidLine),
+                };
+                declared.normals += 1;
+            },
+            .face => {
+                // Format is `f v/vt/vn v/vt/vn v/vt/vn ...`, `vt` and `vn` being optional.
+                const first = try parseCorner(tokens.next() orelse return error.InvalidLine, declared, parser.totals);
+                var previous = try parseCorner(tokens.next() orelse return error.InvalidLine, declared, parser.totals);
+                var triangle_count: usize = 0;
+
+                while (tokens.next()) |token| {
+                    const corner = try parseCorner(token, declared, parser.totals);
+                    parser.faces[declared.faces] = .{
+                        .vertices = .{ first.vertex, previous.vertex, corner.vertex },
+                        .textures = .{ first.texture, previous.texture, corner.texture },
+                        .normals = .{ first.normal, previous.normal, corner.normal },
+                    };
+                    declared.faces += 1;
+                    triangle_count += 1;
+                    previous = corner;
+                }
+
+                if (triangle_count == 0) {
+                    return error.InvalidLine;
+                }
+            },
+        }
+    }
+}
+
+const Corner = struct {
+    vertex: u32,
+    texture: u32,
+    normal: u32,
+};
+
+fn parseCorner(token: []const u8, declared: Counts, totals: Counts) !Corner {
+    const first_slash = indexOfAnyPos(token, 0, "/");
+    const second_slash = if (first_slash < token.len) indexOfAnyPos(token, first_slash + 1, "/") else token.len;
+
+    const vertex = token[0..first_slash];
+    const texture = if (first_slash < token.len) token[first_slash + 1 .. second_slash] else "";
+    const normal = if (second_slash < token.len) token[second_slash + 1 ..] else "";
+
+    return .{
+        .vertex = try resolveIndex(vertex, declared.vertices, totals.vertices) orelse return error.InvalidLine,
+        .texture = try resolveIndex(texture, declared.texture_coords, totals.texture_coords) orelse 0,
+        .normal = try resolveIndex(normal, declared.normals, totals.normals) orelse 0,
+    };
+}
+
+/// Indices start at 1, negative ones count back from the last element declared before the face.
+/// `null` when the index is omitted.
+fn resolveIndex(text: []const u8, declared: usize, total: usize) !?u32 {
+    if (text.len == 0) {
+        return null;
+    }
+
+    const index = try parseInt(text);
+    const resolved = if (index > 0)
+        index - 1
+    else if (index < 0)
+        @as(i64, @intCast(declared)) + index
+    else
+        return error.InvalidIndex;
+
+    if (resolved < 0 or resolved >= total) {
+        return error.InvalidIndex;
+    }
+    return @intCast(resolved);
+}
+
+/// Index of the first byte of `data[pos..]` equal to one of `needles`, `data.len` when there is none.
+fn indexOfAnyPos(data: []const u8, pos: usize, comptime needles: []const u8) usize {
+    const Bytes = @Vector(scan_lanes, u8);
+    const Mask = std.meta.Int(.unsigned, scan_lanes);
+
+    var i = pos;
+    while (i + scan_lanes <= data.len) : (i += scan_lanes) {
+        const bytes: Bytes = data[i..][0..scan_lanes].*;
+        var mask: Mask = 0;
+        inline for (needles) |needle| {
+            mask |= @bitCast(bytes == @as(Bytes, @splat(needle)));
+        }
+        if (mask != 0) {
+            return i + @ctz(mask);
+        }
+    }
+
+    while (i < data.len) : (i += 1) {
+        inline for (needles) |needle| {
+            if (data[i] == needle) return i;
+        }
+    }
+    return data.len;
+}
+
+/// Lines of a chunk, without their `\n`.
+const Lines = struct {
+    data: []const u8,
+    pos: usize = 0,
+
+    fn next(self: *Lines) ?[]const u8 {
+        if (self.pos >= self.data.len) {
+            return null;
+        }
+
+        const end = indexOfAnyPos(self.data, self.pos, "\n");
+        const line = self.data[self.pos..end];
+        self.pos = end + 1;
+        return line;
+    }
+};
+
+/// Drops the pages of a chunk of a file mapping behind the parser, every `release_interval` bytes.
+/// Only whole pages are dropped, those shared with the neighbouring chunks are kept.
+const PageReleaser = struct {
+    data: []const u8,
+    /// Address up to which the pages were dropped, page aligned.
+    released: usize,
+    enabled: bool,
+
+    fn init(data: []const u8, enabled: bool) PageReleaser {
+        return .{
+            .data = data,
+            .released = std.mem.alignForward(usize, @intFromPtr(data.ptr), std.heap.pageSize()),
+            .enabled = enabled,
+        };
+    }
+
+    /// Everything before `pos` was parsed.
+    fn advance(self: *PageReleaser, pos: usize) void {
+        if (!self.enabled) {
+            return;
+        }
+
+        const end = std.mem.alignBackward(usize, @intFromPtr(self.data.ptr) + @min(pos, self.data.len), std.heap.pageSize());
+        if (end < self.released + release_interval and pos < self.data.len) {
+            return;
+        }
+
+        if (end > self.released) {
+            const start: [*]align(std.heap.page_size_min) u8 = @ptrFromInt(self.released);
+            std.posix.madvise(start, end - self.released, std.posix.MADV.DONTNEED) catch {};
+            self.released = end;
+        }
+    }
+};
+
+/// Words of a line, separated by any number of spaces, tabs or a trailing `\r`.
+const Tokens = struct {
+    line: []const u8,
+    pos: usize = 0,
+
+    fn next(self: *Tokens) ?[]const u8 {
+        // Words are usually separated by a single space, a vector compare would not pay off here.
+        while (self.pos < self.line.len and isSpace(self.line[self.pos])) {
+            self.pos += 1;
+        }
+        if (self.pos >= self.line.len) {
+            return null;
+        }
+
+        const start = self.pos;
+        self.pos = indexOfAnyPos(self.line, start, " \t\r");
+        return self.line[start..self.pos];
+    }
+
+    inline fn isSpace(c: u8) bool {
+        return c == ' ' or c == '\t' or c == '\r';
+    }
+};
+
+const pow10_f32 = powersOfTen(f32, 10);
+const pow10_u64 = powersOfTen(u64, 8);
+
+/// Every power of ten up to `10^max`, all exactly representable in `T`.
+fn powersOfTen(comptime T: type, comptime max: usize) [max + 1]T {
+    var powers: [max + 1]T = undefined;
+    powers[0] = 1;
+    for (1..max + 1) |i| {
+        powers[i] = powers[i - 1] * 10;
+    }
+    return powers;
+}
+
+/// Decimal float as written in OBJ files, `[-+]digits[.digits][(e|E)[-+]digits]`.
+/// The significant digits are gathered in an integer and scaled by an exact power of ten in one rounding, which is
+/// correctly rounded when both the digits and the power fit the mantissa of an `f32` (Clinger's fast path), which
+/// covers the usual 6 to 8 digits of OBJ files. Longer numbers, and anything else like `inf` or `nan`, go through
+/// `std.fmt.parseFloat`.
+fn parseFloat(text: []const u8) !f32 {
+    var i: usize = 0;
+    const negative = text.len > 0 and text[0] == '-';
+    if (text.len > 0 and (text[0] == '-' or text[0] == '+')) {
+        i += 1;
+    }
+
+    var mantissa: u64 = 0;
+    var significant_digits: usize = 0;
+    var digit_count: usize = 0;
+    var exponent: i64 = 0;
+    var seen_point = false;
+
+    while (i < text.len) : (i += 1) {
+        const c = text[i];
+        if (c >= '0' and c <= '9') {
+            mantissa = mantissa *% 10 +% (c - '0');
+            digit_count += 1;
+            if (mantissa != 0) significant_digits += 1;
+            if (seen_point) exponent -= 1;
+        } else if (c == '.' and !seen_point) {
+            seen_point = true;
+        } else {
+            break;
+        }
+    }
+
+    if (i < text.len and (text[i] == 'e' or text[i] == 'E')) {
+        i += 1;
+        const exponent_negative = i < text.len and text[i] == '-';
+        if (i < text.len and (text[i] == '-' or text[i] == '+')) {
+            i += 1;
+        }
+
+        var exponent_value: i64 = 0;
+        const start = i;
+        while (i < text.len and text[i] >= '0' and text[i] <= '9' and i - start < 9) : (i += 1) {
+            exponent_value = exponent_value * 10 + (text[i] - '0');
+        }
+        if (i == start) {
+            return std.fmt.parseFloat(f32, text);
+        }
+        exponent += if (exponent_negative) -exponent_value else exponent_value;
+    }
+
+    // Trailing characters, no digits at all or more digits than a u64 holds.
+    if (i != text.len or digit_count == 0 or significant_digits > 19) {
+        return std.fmt.parseFloat(f32, text);
+    }
+
+    // Going through an `f64` first would round twice, which is not always correctly rounded.
+    if (mantissa > 1 << 24 or exponent < -10 or exponent > 10) {
+        return std.fmt.parseFloat(f32, text);
+    }
+
+    const m: f32 = @floatFromInt(mantissa);
+    const value = if (exponent < 0) m / pow10_f32[@intCast(-exponent)] else m * pow10_f32[@intCast(exponent)];
+    return if (negative) -value else value;
+}
+
+/// Decimal integer with an optional `-`, decoded 8 digits at a time without a branch per digit.
+fn parseInt(text: []const u8) !i64 {
+    const negative = text.len > 0 and text[0] == '-';
+    var digits = if (negative) text[1..] else text;
+
+    // 18 digits always fit in an i64.
+    if (digits.len == 0 or digits.len > 18) {
+        return error.InvalidIndex;
+    }
+
+    const Bytes = @Vector(8, u8);
+    var value: u64 = 0;
+
+    while (digits.len > 0) {
+        const n = @min(digits.len, 8);
+
+        // Right aligned so the padding reads as leading zeros.
+        var buffer: [8]u8 = @splat('0');
+        @memcpy(buffer[8 - n ..], digits[0..n]);
+
+        const bytes: Bytes = buffer;
+        if (@reduce(.Or, bytes -% @as(Bytes, @splat('0')) > @as(Bytes, @splat(9)))) {
+            return error.InvalidIndex;
+        }
+
+        value = value * pow10_u64[n] + eightDigits(std.mem.readInt(u64, &buffer, .little));
+        digits = digits[n..];
+    }
+
+    const signed: i64 = @intCast(value);
+    return if (negative) -signed else signed;
+}
+
+/// Value of 8 ASCII digits loaded little-endian, the first digit being the most significant.
+/// Adjacent digits are combined in pairs, then pairs of pairs, with one multiply each.
+inline fn eightDigits(chunk: u64) u64 {
+    var v = chunk -% 0x3030303030303030;
+    v = (v *% 10 +% (v >> 8)) & 0x00ff00ff00ff00ff;
+    v = (v *% 100 +% (v >> 16)) & 0x0000ffff0000ffff;
+    v = (v *% 10000 +% (v >> 32)) & 0x00000000ffffffff;
+    return v;
+}
+
+fn expectSameMesh(expected: *const Mesh, actual: *const Mesh) !void {
+    inline for (.{ "vertices", "textureCoords", "normals", "faces", "vertexBuffer", "indexBuffer" }) |field| {
+        try std.testing.expectEqualSlices(u8, std.mem.sliceAsBytes(@field(expected, field)), std.mem.sliceAsBytes(@field(actual, field)));
+    }
+}
+
+test "parse gives the same mesh on one thread and in chunks" {
+    const data =
+        "# A square and a pentagon.\n" ++
+        "v 0 0 0\n" ++
+        "v 1 0 0\r\n" ++
+        "v\t1 1 0\n" ++
+        "v 0 1 0\n" ++
+        "\n" ++
+        "v 0.5 2 0\n" ++
+        "vt 0 0\n" ++
+        "vt 1 0\n" ++
+        "vt 1 1\n" ++
+        "vn 0 0 1\n" ++
+        "f 1 2 3\n" ++
+        "f -5 -4 -3 -2 -1\n" ++
+        "f 1//1 2//1 3//1\n" ++
+        "f 1/1 2/2 3/3\r\n" ++
+        "f\t1/1/1\t2/2/1  3/3/1 \n" ++
+        "v 2 2 2\n" ++
+        "f -1 -2 -3";
+
+    const single = try parse(std.testing.allocator, data, .{ .thread_count = 1 });
+    defer single.deinit();
+
+    try std.testing.expectEqual(6, single.vertices.len);
+    try std.testing.expectEqual(3, single.textureCoords.len);
+    try std.testing.expectEqual(1, single.normals.len);
+    try std.testing.expectEqual(8, single.faces.len);
+
+    try std.testing.expectEqual(Vector3{ .x = 1, .y = 1, .z = 0 }, single.vertices[2]);
+
+    // The pentagon is split in a fan around its first corner.
+    try std.testing.expectEqual([3]u32{ 0, 1, 2 }, single.faces[1].vertices);
+    try std.testing.expectEqual([3]u32{ 0, 2, 3 }, single.faces[2].vertices);
+    try std.testing.expectEqual([3]u32{ 0, 3, 4 }, single.faces[3].vertices);
+
+    // `v//vn`, `v/vt` and `v/vt/vn` corners, omitted indices point at the first element.
+    try std.testing.expectEqual(Face{ .vertices = .{ 0, 1, 2 }, .textures = .{ 0, 0, 0 }, .normals = .{ 0, 0, 0 } }, single.faces[4]);
+    try std.testing.expectEqual(Face{ .vertices = .{ 0, 1, 2 }, .textures = .{ 0, 1, 2 }, .normals = .{ 0, 0, 0 } }, single.faces[5]);
+    try std.testing.expectEqual(Face{ .vertices = .{ 0, 1, 2 }, .textures = .{ 0, 1, 2 }, .normals = .{ 0, 0, 0 } }, single.faces[6]);
+
+    // Relative indices count from the last vertex declared before the face.
+    try std.testing.expectEqual([3]u32{ 5, 4, 3 }, single.faces[7].vertices);
+
+    // Chunks of a few bytes, so every boundary falls somewhere else.
+    for ([_]usize{ 2, 3, 4, 7, 16, 64 }) |thread_count| {
+        const chunked = try parse(std.testing.allocator, data, .{ .thread_count = thread_count, .min_chunk_size = 1 });
+        defer chunked.deinit();
+        try expectSameMesh(&single, &chunked);
+    }
+}
+
+test "parse rejects invalid faces" {
+    const triangle = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\n";
+    const cases = [_]struct { data: []const u8, err: anyerror }{
+        .{ .data = triangle ++ "f 1 2 4\n", .err = error.InvalidIndex },
+        .{ .data = triangle ++ "f 0 1 2\n", .err = error.InvalidIndex },
+        .{ .data = triangle ++ "f -4 -1 -2\n", .err = error.InvalidIndex },
+        .{ .data = "f -1 -2 -3\n" ++ triangle, .err = error.InvalidIndex },
+        .{ .data = triangle ++ "f 1/2 2/1 3/1\n", .err = error.InvalidIndex },
+        .{ .data = triangle ++ "f 1//1 2//1 3//1\n", .err = error.InvalidIndex },
+        .{ .data = triangle ++ "f 1 2\n", .err = error.InvalidLine },
+        .{ .data = triangle ++ "f 1\n", .err = error.InvalidLine },
+        .{ .data = triangle ++ "f\n", .err = error.InvalidLine },
+        .{ .data = triangle ++ "f 1 x 3\n", .err = error.InvalidIndex },
+        .{ .data = "v 0 0\n", .err = error.InvalidLine },
+    };
+
+    for (cases) |case| {
+        for ([_]Options{ .{ .thread_count = 1 }, .{ .thread_count = 4, .min_chunk_size = 1 } }) |options| {
+            try std.testing.expectError(case.err, parse(std.testing.allocator, case.data, options));
+        }
+    }
+}
+
+fn expectSameFloat(text: []const u8) !void {
+    const expected = try std.fmt.parseFloat(f32, text);
+    const actual = try parseFloat(text);
+    std.testing.expectEqual(@as(u32, @bitCast(expected)), @as(u32, @bitCast(actual))) catch |err| {
+        std.debug.print("parseFloat(\"{s}\") = {e}, expected {e}\n", .{ text, actual, expected });
+        return err;
+    };
+}
+
+test "parseFloat rounds like std.fmt.parseFloat" {
+    const cases = [_][]const u8{
+        // Signs and leading zeros.
+        "0",                      "-0",                   "+0",                     "1",
+        "-1",                     "+1.5",                 "007.25",                 "-000.0001",
+        // Missing integer or fraction digits.
+        "1.",                     ".5",                   "-.5",                    "0.",
+        // Exponents, in and out of the fast path.
+        "1e3",                    "1E-3",                 "2.5e+2",                 "-7.125e-5",
+        "1e10",                   "1e-10",                "1e11",                   "1e-11",
+        "3.4028235e38",           "1e-45",                "1e39",                   "1e-50",
+        "1e000000010",            "1e0000000001",
+        // Usual OBJ values.
+        "0.1",                    "0.123456",             "-0.12345678",            "0.999999",
+        // Around the largest exact mantissa.
+        "16777216",               "16777217",             "16777218",               "1.6777217",
+        // 9 to 20 significant digits, going through `std.fmt`.
+        "123456789",              "0.30000001192092896",  "12345678901234567",      "0.12345678901234567",
+        "1234567890123456789",    "12345678901234567890", "-98765432109876543210e-10",
+        "1.00000005960464477539", "9007199254740993",     "0.000000000000000000001",
+    };
+    for (cases) |text| {
+        try expectSameFloat(text);
+    }
+}
+
+test "parseFloat rejects what is not a number" {
+    const cases = [_][]const u8{ "", "+", "-", ".", "-.", "e5", "1e", "1e+", "1.2.3", "1x", "x1", "--1", "1 2" };
+    for (cases) |text| {
+        try std.testing.expect(std.meta.isError(parseFloat(text)));
+    }
+}
+
+test "parseInt matches std.fmt.parseInt" {
+    const cases = [_][]const u8{
+        "0",        "-0",        "1",           "-1",          "7",                  "42",
+        "007",      "-0012",     "10000000",    "99999999",    "12345678",           "123456789",
+        "-9999999", "100000000", "-9999999999", "00000000001", "999999999999999999", "-123456789012345678",
+    };
+    for (cases) |text| {
+        try std.testing.expectEqual(try std.fmt.parseInt(i64, text, 10), try parseInt(text));
+    }
+
+    // Every length, from 1 to 18 digits.
+    const digits = "918273645546372819";
+    for (1..digits.len + 1) |n| {
+        try std.testing.expectEqual(try std.fmt.parseInt(i64, digits[0..n], 10), try parseInt(digits[0..n]));
+
+        var negative: [digits.len + 1]u8 = undefined;
+        negative[0] = '-';
+        @memcpy(negative[1 .. n + 1], digits[0..n]);
+        try std.testing.expectEqual(try std.fmt.parseInt(i64, negative[0 .. n + 1], 10), try parseInt(negative[0 .. n + 1]));
+    }
+}
+
+test "parseInt rejects signs without digits and non-digits" {
+    // `/` and `:` surround the digits in ASCII.
+    const cases = [_][]const u8{
+        "",    "+",    "-",   "+1",      "--1",       "1-",        "1a",  "a1",
+        "/",   ":",    "1/2", "12345:7", "123456/89", "1 2",       "1.0", "0x10",
+        "1e3", "1234567890123456789",
+    };
+    for (cases) |text| {
+        try std.testing.expectError(error.InvalidIndex, parseInt(text));
+    }
+}
+
+test "eightDigits decodes eight ASCII digits" {
+    const cases = [_]*const [8]u8{ "00000000", "00000001", "10000000", "12345678", "87654321", "99999999", "09090909" };
+    for (cases) |text| {
+        try std.testing.expectEqual(try std.fmt.parseInt(u64, text, 10), eightDigits(std.mem.readInt(u64, text, .little)));
+    }
+}
@@ -0,0 +1,47 @@
+//! Worker pool shared by the tile renderer and the OBJ parser, jobs are spread over the workers and the calling
+//! thread, which works while waiting for them.
+
+const std = @import("std");
+
+const Allocator = std.mem.Allocator;
+const Pool = std.Thread.Pool;
+
+/// Threads to run on, `0` meaning every available core.
+pub fn threadCount(requested: usize) usize {
+    return if (requested == 0) std.Thread.getCpuCount() catch 1 else requested;
+}
+
+/// Pool for `thread_count` threads in total, `null` for a single thread. Free it with `deinitPool`.
+pub fn initPool(allocator: Allocator, thread_count: usize) !?*Pool {
+    if (thread_count <= 1) {
+        return null;
+    }
+
+    const pool = try allocator.create(Pool);
+    errdefer allocator.destroy(pool);
+    // The calling thread also works while waiting, so it counts as one of the threads.
+    try pool.init(.{ .allocator = allocator, .n_jobs = @as(u32, @intCast(thread_count - 1)) });
+    return pool;
+}
+
+pub fn deinitPool(allocator: Allocator, pool: ?*Pool) void {
+    if (pool) |p| {
+        p.deinit();
+        allocator.destroy(p);
+    }
+}
+
+/// Run `job(context, index)` for every index below `count` and return once they are all done.
+/// Without a pool, they run in order on the calling thread.
+pub fn forEach(pool: ?*Pool, context: anytype, count: usize, comptime job: fn (@TypeOf(context), usize) void) void {
+    const p = pool orelse {
+        for (0..count) |index| job(context, index);
+        return;
+    };
+
+    var wait_group: std.Thread.WaitGroup = .{};
+    for (0..count) |index| {
+        p.spawnWg(&wait_group, job, .{ context, index });
+    }
+    p.waitAndWork(&wait_group);
+}
@@ -0,0 +1,222 @@
+//! Scoped timing zones, compiled out unless built with `-Dprofile=true`.
+//!
+//! ```
+//! const zone = profile.begin("draw");
+//! defer zone.end();
+//! ```
+//!
+//! Zones may be opened from any thread. Every thread records its zones in its own buffer, so closing a zone never
+//! waits on another thread, and they are written as a Chrome `trace_event` file by `writeTrace`.
+
+const std = @import("std");
+const build_options = @import("build_options");
+
+pub const enabled = build_options.profile;
+
+/// A closed zone, times are in nanoseconds since `init`.
+pub const Event = struct {
+    name: []const u8,
+    start: u64,
+    duration: u64,
+};
+
+/// Time spent in every zone of a name.
+pub const Total = struct {
+    name: []const u8,
+    duration: u64,
+};
+
+/// Zones kept per thread, older ones are overwritten so the trace covers the end of the session.
+/// About 2 MB per thread.
+const ring_capacity = 1 << 16;
+/// Distinct zone names summed per thread by `frameTotals`, further names are only traced.
+const max_names = 32;
+
+/// Zones closed by one thread. Only that thread writes to it.
+const ThreadProfile = struct {
+    thread_id: std.Thread.Id,
+    /// The latest zones, `closed` counting every zone ever closed by the thread.
+    events: [ring_capacity]Event = undefined,
+    closed: usize = 0,
+    /// Time spent in every zone name since the previous `frameTotals`, kept apart from `events` so the overlay
+    /// does not depend on which zones the trace still holds.
+    totals: [max_names]NameTotal = undefined,
+    /// Published with a release store once the name of the new total is written.
+    name_count: std.atomic.Value(usize) = .init(0),
+    next: ?*ThreadProfile = null,
+
+    fn record(self: *ThreadProfile, event: Event) void {
+        self.events[self.closed % ring_capacity] = event;
+        self.closed += 1;
+
+        const name_count = self.name_count.raw;
+        for (self.totals[0..name_count]) |*total| {
+            if (std.mem.eql(u8, total.name, event.name)) {
+                _ = total.duration.fetchAdd(event.duration, .monotonic);
+                return;
+            }
+        }
+
+        if (name_count < max_names) {
+            self.totals[name_count] = .{ .name = event.name, .duration = .init(event.duration) };
+            self.name_count.store(name_count + 1, .release);
+        }
+    }
+};
+
+const NameTotal = struct {
+    name: []const u8,
+    duration: std.atomic.Value(u64),
+};
+
+/// Guards `threads`, only taken when a thread closes its first zone, and to read every thread.
+var mutex: std.Thread.Mutex = .{};
+var threads: ?*ThreadProfile = null;
+threadlocal var current: ?*ThreadProfile = null;
+var epoch: ?std.time.Instant = null;
+
+pub const Zone = if (enabled) struct {
+    name: []const u8,
+    start: u64,
+
+    pub fn end(self: Zone) void {
+        const end_time = now();
+        const thread = current orelse register() orelse return;
+
+        thread.record(.{
+            .name = self.name,
+            .start = self.start,
+            .duration = end_time -| self.start,
+        });
+    }
+} else struct {
+    pub inline fn end(_: Zone) void {}
+};
+
+pub inline fn begin(comptime name: []const u8) Zone {
+    if (enabled) {
+        return .{ .name = name, .start = now() };
+    } else {
+        return .{};
+    }
+}
+
+/// Start the clock, before any zone is opened.
+pub fn init() void {
+    if (enabled) {
+        epoch = std.time.Instant.now() catch null;
+    }
+}
+
+/// Free the buffers of every thread, once no zone can be closed anymore.
+pub fn deinit() void {
+    mutex.lock();
+    defer mutex.unlock();
+
+    while (threads) |thread| {
+        threads = thread.next;
+        std.heap.page_allocator.destroy(thread);
+    }
+    current = null;
+}
+
+/// Give the calling thread its buffer, `null` when it cannot be allocated and the zone is dropped.
+fn register() ?*ThreadProfile {
+    const thread = std.heap.page_allocator.create(ThreadProfile) catch return null;
+    // Field by field, a whole struct literal could be built on the stack first.
+    thread.thread_id = std.Thread.getCurrentId();
+    thread.closed = 0;
+    thread.name_count = .init(0);
+    thread.next = null;
+
+    mutex.lock();
+    defer mutex.unlock();
+
+    thread.next = threads;
+    threads = thread;
+    current = thread;
+    return thread;
+}
+
+fn now() u64 {
+    const start = epoch orelse return 0;
+    const instant = std.time.Instant.now() catch return 0;
+    return instant.since(start);
+}
+
+/// Sum the zones closed since the previous call by name, over every thread, at most `buffer.len` names.
+pub fn frameTotals(buffer: []Total) []Total {
+    if (!enabled) {
+        return buffer[0..0];
+    }
+
+    mutex.lock();
+    defer mutex.unlock();
+
+    var count: usize = 0;
+    var thread = threads;
+    while (thread) |t| : (thread = t.next) {
+        const name_count = t.name_count.load(.acquire);
+
+        next: for (t.totals[0..name_count]) |*name_total| {
+            const duration = name_total.duration.swap(0, .monotonic);
+            if (duration == 0) {
+                continue;
+            }
+
+            for (buffer[0..count]) |*total| {
+                if (std.mem.eql(u8, total.name, name_total.name)) {
+                    total.duration += duration;
+                    continue :next;
+                }
+            }
+
+            if (count < buffer.len) {
+                buffer[count] = .{ .name = name_total.name, .duration = duration };
+                count += 1;
+            }
+        }
+    }
+
+    return buffer[0..count];
+}
+
+/// Write the zones kept by every thread in the Chrome `trace_event` format, to be opened with `chrome://tracing`
+/// or Perfetto. The other threads must not be closing zones anymore.
+pub fn writeTrace(path: []const u8) !void {
+    if (!enabled) {
+        return;
+    }
+
+    const file = try std.fs.cwd().createFile(path, .{});
+    defer file.close();
+
+    var buffered = std.io.bufferedWriter(file.writer());
+    const writer = buffered.writer();
+
+    mutex.lock();
+    defer mutex.unlock();
+
+    try writer.writeAll("{\"traceEvents\":[\n");
+    var first = true;
+    var thread = threads;
+    while (thread) |t| : (thread = t.next) {
+        if (t.closed > ring_capacity) {
+            std.log.warn("profile: thread {} dropped its first {} zones", .{ t.thread_id, t.closed - ring_capacity });
+        }
+
+        for (t.closed -| ring_capacity..t.closed) |index| {
+            const event = t.events[index % ring_capacity];
+            try writer.print("{s}{{\"name\":\"{s}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{d:.3},\"dur\":{d:.3}}}", .{
+                if (first) "" else ",\n",
+                event.name,
+                t.thread_id,
+                @as(f64, @floatFromInt(event.start)) / std.time.ns_per_us,
+                @as(f64, @floatFromInt(event.duration)) / std.time.ns_per_us,
+            });
+            first = false;
+        }
+    }
+    try writer.writeAll("\n]}\n");
+    try buffered.flush();
+}